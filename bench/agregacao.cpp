@@ -0,0 +1,75 @@
+#include <agregacao.h>
+#include <simd.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+// Quantidade de valores agregados (em milhões), se não for informada.
+#define BENCH_QUANTIDADE_PADRAO 16
+
+// Repetições de cada medição, para diluir o custo de aquecimento.
+#define BENCH_REPETICOES 10
+
+/*
+ * Compara a vazão (valores/segundo) da agregação de uma coluna em cada
+ * implementação disponível, sobre valores sintéticos com ~5% de ausentes.
+ */
+int main(int argc, char *argv[])
+{
+    long long milhoes = argc > 1 ? atoll(argv[1]) : BENCH_QUANTIDADE_PADRAO;
+    long long quantidade = milhoes * 1000000;
+
+    std::vector<double> valores(quantidade);
+    srand(42);
+    for (long long i = 0; i < quantidade; i++)
+    {
+        if (rand() % 100 < 5)
+            valores[i] = std::numeric_limits<double>::quiet_NaN();
+        else
+            valores[i] = (rand() % 20000 - 10000) / 10.0;
+    }
+
+    int maximo = SimdGetNivel();
+    Agregado referencia;
+
+    printf("%-10s %16s %12s %16s %12s %12s\n", "nivel", "valores M/s", "validos", "soma", "minimo", "maximo");
+
+    for (int nivel = SIMD_ESCALAR; nivel <= maximo; nivel++)
+    {
+        SimdDefinirNivel(nivel);
+
+        Agregado agregado;
+        auto comeco = std::chrono::steady_clock::now();
+
+        for (int r = 0; r < BENCH_REPETICOES; r++)
+        {
+            agregado = Agregado();
+            AgregarColuna(valores.data(), quantidade, &agregado);
+        }
+
+        double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - comeco).count();
+
+        if (nivel == SIMD_ESCALAR)
+            referencia = agregado;
+
+        // Sanidade: a soma muda de ordem entre as implementações, o resto não pode mudar.
+        double tolerancia = 1e-9 * std::fabs(referencia.soma) + 1e-6;
+        if (agregado.quantidade != referencia.quantidade || agregado.validos != referencia.validos ||
+            agregado.minimo != referencia.minimo || agregado.maximo != referencia.maximo ||
+            std::fabs(agregado.soma - referencia.soma) > tolerancia)
+        {
+            fprintf(stderr, "%s diverge da implementacao escalar\n", SimdGetNome(nivel));
+            return 1;
+        }
+
+        printf("%-10s %16.1f %12lld %16.1f %12.1f %12.1f\n", SimdGetNome(nivel),
+               quantidade * (double)BENCH_REPETICOES / segundos / 1e6, agregado.validos, agregado.soma,
+               agregado.minimo, agregado.maximo);
+    }
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <alocador.h>
+#include <arvore.h>
+#include <momento.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// Quantidade de nós criados (em milhares), se não for informada: cerca de 20 anos horários.
+#define BENCH_QUANTIDADE_PADRAO 175
+
+typedef std::chrono::steady_clock Relogio;
+
+static double segundosDesde(Relogio::time_point comeco)
+{
+    return std::chrono::duration<double>(Relogio::now() - comeco).count();
+}
+
+/*
+ * Mede a montagem, o percurso e a destruição de uma árvore de momentos
+ * com o alocador informado.
+ */
+template <template <typename> class Alocador>
+static void medir(const char *nome, long long quantidade)
+{
+    // Momentos horários em ordem, como na indexação de um arquivo do INMET.
+    Relogio::time_point comeco = Relogio::now();
+    auto arvore = new Arvore<Momento, long long, Alocador>();
+    for (long long h = 0; h < quantidade; h++)
+    {
+        Momento momento = Momento::DeHoras(h + 24 * 12784);
+        arvore->Inserir(momento, h);
+    }
+    double montagem = segundosDesde(comeco);
+
+    long long soma = 0;
+    comeco = Relogio::now();
+    arvore->ParaCada([&soma](typename Arvore<Momento, long long, Alocador>::No *no) -> bool
+                     {
+                         soma += no->valor;
+                         return true;
+                     });
+    double percurso = segundosDesde(comeco);
+
+    comeco = Relogio::now();
+    delete arvore;
+    double destruicao = segundosDesde(comeco);
+
+    // Sanidade: o percurso precisa ter visitado todos os nós.
+    if (soma != quantidade * (quantidade - 1) / 2)
+    {
+        fprintf(stderr, "%s: percurso incompleto\n", nome);
+        exit(1);
+    }
+
+    printf("%-8s %14.2f %14.2f %14.2f\n", nome, montagem * 1e3, percurso * 1e3, destruicao * 1e3);
+}
+
+/*
+ * Compara o pool de blocos com new/delete por nó na árvore.
+ * Todos os tempos em milissegundos.
+ */
+int main(int argc, char *argv[])
+{
+    long long milhares = argc > 1 ? atoll(argv[1]) : BENCH_QUANTIDADE_PADRAO;
+    long long quantidade = milhares * 1000;
+
+    printf("%-8s %14s %14s %14s\n", "alocador", "arvore monta", "arvore visita", "arvore destroi");
+
+    medir<AlocadorNew>("new", quantidade);
+    medir<AlocadorPool>("pool", quantidade);
+
+    return 0;
+}
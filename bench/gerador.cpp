@@ -0,0 +1,194 @@
+#include <gerador.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::steady_clock Relogio;
+
+/*
+ * Nomes das variantes de formato na linha de comando.
+ */
+static const struct
+{
+    const char *nome;
+    int variante;
+} variantes_conhecidas[] = {
+    {"data-hifen", GERADOR_DATA_HIFEN},
+    {"hora-dois-pontos", GERADOR_HORA_DOIS_PONTOS},
+    {"decimal-ponto", GERADOR_DECIMAL_PONTO},
+    {"linhas-vazias", GERADOR_LINHAS_VAZIAS},
+    {"crlf", GERADOR_CRLF},
+    {"sem-quebra-final", GERADOR_SEM_QUEBRA_FINAL},
+    {"misturar", GERADOR_MISTURAR},
+};
+
+/*
+ * @brief Interpreta uma lista de variantes separadas por ','.
+ * @return false se alguma variante é desconhecida.
+ */
+static bool analisarVariantes(const char *lista, int *variantes)
+{
+    std::string texto(lista);
+    size_t inicio = 0;
+
+    while (inicio <= texto.size())
+    {
+        size_t fim = texto.find(',', inicio);
+        if (fim == std::string::npos)
+            fim = texto.size();
+
+        std::string nome = texto.substr(inicio, fim - inicio);
+        bool conhecida = false;
+        for (const auto &variante : variantes_conhecidas)
+        {
+            if (nome == variante.nome || nome == "todas")
+            {
+                *variantes |= variante.variante;
+                conhecida = true;
+            }
+        }
+
+        if (!conhecida && !nome.empty())
+            return false;
+
+        inicio = fim + 1;
+    }
+
+    return true;
+}
+
+static void imprimirUso()
+{
+    fprintf(stderr, "uso: series_gerador [opções] <arquivo.csv>\n");
+    fprintf(stderr, "  --anos N            Anos de dados horários terminando em 2024 (padrão: 10).\n");
+    fprintf(stderr, "  --de AAAA --ate AAAA  Primeiro e último ano, no lugar de --anos.\n");
+    fprintf(stderr, "  --estacoes N        Gera N arquivos, \"arquivo_0001.csv\" em diante, em paralelo.\n");
+    fprintf(stderr, "  --ausentes F        Fração de valores ausentes, vazios ou -9999 (padrão: 0.05).\n");
+    fprintf(stderr, "  --lacunas F         Fração aproximada de horas sem linha (padrão: 0).\n");
+    fprintf(stderr, "  --variantes LISTA   Variantes de formato separadas por ',': data-hifen,\n");
+    fprintf(stderr, "                      hora-dois-pontos, decimal-ponto, linhas-vazias, crlf,\n");
+    fprintf(stderr, "                      sem-quebra-final, misturar, ou todas.\n");
+    fprintf(stderr, "  --semente N         Semente dos valores sorteados (padrão: 42).\n");
+}
+
+/*
+ * Gera arquivos sintéticos no formato do INMET, para testes de escala e dos
+ * casos de borda do analisador, sem depender de arquivos reais das estações.
+ */
+int main(int argc, char *argv[])
+{
+    OpcoesGerador opcoes = GetOpcoesGeradorPadrao(10);
+    const char *caminho = nullptr;
+    int estacoes = 1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool valor = i + 1 < argc;
+
+        if (strcmp(argv[i], "--anos") == 0 && valor)
+            opcoes.ano_inicial = opcoes.ano_final - atoi(argv[++i]) + 1;
+        else if (strcmp(argv[i], "--de") == 0 && valor)
+            opcoes.ano_inicial = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--ate") == 0 && valor)
+            opcoes.ano_final = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--estacoes") == 0 && valor)
+            estacoes = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--ausentes") == 0 && valor)
+            opcoes.ausentes = atof(argv[++i]);
+        else if (strcmp(argv[i], "--lacunas") == 0 && valor)
+            opcoes.lacunas = atof(argv[++i]);
+        else if (strcmp(argv[i], "--semente") == 0 && valor)
+            opcoes.semente = strtoull(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--variantes") == 0 && valor)
+        {
+            if (!analisarVariantes(argv[++i], &opcoes.variantes))
+            {
+                imprimirUso();
+                return 1;
+            }
+        }
+        else if (argv[i][0] != '-' && caminho == nullptr)
+            caminho = argv[i];
+        else
+        {
+            imprimirUso();
+            return 1;
+        }
+    }
+
+    if (caminho == nullptr || estacoes < 1 || opcoes.ano_inicial < 1 || opcoes.ano_inicial > opcoes.ano_final ||
+        opcoes.ano_final > 9999)
+    {
+        imprimirUso();
+        return 1;
+    }
+
+    // Com várias estações, o número de cada uma vai antes da extensão.
+    std::vector<std::string> arquivos;
+    if (estacoes == 1)
+        arquivos.push_back(caminho);
+    else
+    {
+        std::string base(caminho);
+        std::string extensao;
+        size_t ponto = base.rfind('.');
+        if (ponto != std::string::npos && base.find('/', ponto) == std::string::npos)
+        {
+            extensao = base.substr(ponto);
+            base.resize(ponto);
+        }
+
+        for (int e = 1; e <= estacoes; e++)
+        {
+            char numero[16];
+            snprintf(numero, sizeof(numero), "_%04d", e);
+            arquivos.push_back(base + numero + extensao);
+        }
+    }
+
+    // Cada thread pega a próxima estação ainda não gerada.
+    std::atomic<int> proxima(0);
+    std::atomic<long long> linhas(0), bytes(0);
+    std::atomic<bool> falhou(false);
+
+    Relogio::time_point comeco = Relogio::now();
+
+    auto gerar = [&]()
+    {
+        for (int e = proxima++; e < estacoes; e = proxima++)
+        {
+            OpcoesGerador estacao = opcoes;
+            estacao.estacao = e + 1;
+
+            long long l = 0, b = 0;
+            if (!GerarArquivo(arquivos[e].c_str(), estacao, &l, &b))
+            {
+                fprintf(stderr, "não foi possível escrever %s\n", arquivos[e].c_str());
+                falhou = true;
+            }
+            linhas += l;
+            bytes += b;
+        }
+    };
+
+    int tarefas = std::min<int>(estacoes, std::max<int>(1, (int)std::thread::hardware_concurrency()));
+    std::vector<std::thread> threads;
+    for (int t = 1; t < tarefas; t++)
+        threads.emplace_back(gerar);
+    gerar();
+    for (std::thread &thread : threads)
+        thread.join();
+
+    double segundos = std::chrono::duration<double>(Relogio::now() - comeco).count();
+    fprintf(stderr, "%d arquivo(s), %lld linhas, %.1f MiB em %.2f s (%.0f MiB/s)\n", estacoes, linhas.load(),
+            bytes / 1048576.0, segundos, bytes / 1048576.0 / segundos);
+
+    return falhou ? 1 : 0;
+}
@@ -0,0 +1,497 @@
+#include <gerador.h>
+#include <persistencia.h>
+#include <serie.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Anos de dados horários dos arquivos gerados, se nenhum arquivo for informado.
+#define BENCH_ANOS_PADRAO "1,10,50"
+
+// Consultas pontuais feitas em cada arquivo, se não for informado.
+#define BENCH_CONSULTAS_PADRAO 20000
+
+// Quantas vezes o arquivo é carregado; vale a mediana.
+#define BENCH_CARGAS 3
+
+// Linhas visitadas, no máximo, pelas consultas de cada largura de intervalo.
+#define BENCH_LINHAS_POR_LARGURA 200000
+
+// Consultas de cada largura de intervalo, no mínimo; o máximo é o de consultas pontuais.
+#define BENCH_MINIMO_INTERVALOS 5
+
+typedef std::chrono::steady_clock Relogio;
+
+static double segundosDesde(Relogio::time_point comeco)
+{
+    return std::chrono::duration<double>(Relogio::now() - comeco).count();
+}
+
+/*
+ * Opções de carga aceitas na linha de comando, com os mesmos nomes do programa.
+ */
+static const struct
+{
+    const char *nome;
+    int opcao;
+} opcoes_conhecidas[] = {
+    {"--indice-compacto", SERIES_INDICE_COMPACTO},
+    {"--mapear", SERIES_MAPEAR},
+    {"--paralelo", SERIES_PARALELO},
+    {"--indice-persistente", SERIES_INDICE_PERSISTENTE},
+    {"--carregar-tudo", SERIES_CARREGAR_TUDO},
+    {"--piramide", SERIES_PIRAMIDE},
+    {"--indice-sazonal", SERIES_INDICE_SAZONAL},
+};
+
+/*
+ * Larguras de intervalo medidas em GetLinhas e Agregar. Largura 0 é o arquivo inteiro.
+ */
+static const struct
+{
+    const char *nome;
+    long long horas;
+} larguras[] = {
+    {"dia", 24},
+    {"mes", 24 * 30},
+    {"ano", 24 * 365},
+    {"tudo", 0},
+};
+
+/*
+ * Resultado de uma série de consultas do mesmo tipo.
+ */
+typedef struct Medicao
+{
+    std::string nome;
+    long long consultas;
+    long long linhas;
+    // Soma das latências; nas medições com várias threads, o tempo de parede.
+    double segundos;
+    double p50, p90, p99, maximo;
+} Medicao;
+
+/*
+ * Resultado das medições de um arquivo.
+ */
+typedef struct Relatorio
+{
+    std::string arquivo;
+    long long bytes;
+    long long linhas;
+    double carga;
+    double carga_quente; // lendo o índice salvo; 0 sem --indice-persistente
+    long long rss_pico;
+    std::vector<Medicao> medicoes;
+} Relatorio;
+
+/*
+ * @brief Zera o pico de memória residente do processo, quando o sistema permite.
+ */
+static void zerarPicoMemoria()
+{
+    FILE *arquivo = fopen("/proc/self/clear_refs", "w");
+    if (arquivo == nullptr)
+        return;
+    fputs("5", arquivo);
+    fclose(arquivo);
+}
+
+/*
+ * @brief Pico de memória residente (KiB) desde o último zerarPicoMemoria().
+ */
+static long long getPicoMemoria()
+{
+    FILE *arquivo = fopen("/proc/self/status", "r");
+    if (arquivo != nullptr)
+    {
+        char linha[256];
+        long long pico = -1;
+        while (fgets(linha, sizeof(linha), arquivo) != nullptr)
+        {
+            if (strncmp(linha, "VmHWM:", 6) == 0)
+            {
+                pico = atoll(linha + 6);
+                break;
+            }
+        }
+        fclose(arquivo);
+        if (pico >= 0)
+            return pico;
+    }
+
+    // Sem /proc, o pico do processo inteiro.
+    struct rusage uso;
+    getrusage(RUSAGE_SELF, &uso);
+    return uso.ru_maxrss;
+}
+
+/*
+ * @brief Percentil (0 a 1) de latências já ordenadas.
+ */
+static double percentil(const std::vector<double> &ordenadas, double p)
+{
+    if (ordenadas.empty())
+        return 0;
+
+    size_t posicao = (size_t)(p * (ordenadas.size() - 1) + 0.5);
+    return ordenadas[posicao];
+}
+
+static Medicao resumir(const char *nome, std::vector<double> &latencias, long long linhas)
+{
+    std::sort(latencias.begin(), latencias.end());
+
+    Medicao medicao;
+    medicao.nome = nome;
+    medicao.consultas = (long long)latencias.size();
+    medicao.linhas = linhas;
+    medicao.segundos = 0;
+    for (double latencia : latencias)
+        medicao.segundos += latencia;
+
+    medicao.p50 = percentil(latencias, 0.50);
+    medicao.p90 = percentil(latencias, 0.90);
+    medicao.p99 = percentil(latencias, 0.99);
+    medicao.maximo = latencias.empty() ? 0 : latencias.back();
+    return medicao;
+}
+
+/*
+ * @brief Carrega o arquivo e mede as consultas sobre ele.
+ * @return false se o arquivo não tem linhas.
+ */
+static bool medirArquivo(const char *caminho, int opcoes, long long consultas, int threads, Relatorio *relatorio)
+{
+    struct stat info;
+    if (stat(caminho, &info) != 0)
+        return false;
+
+    relatorio->arquivo = caminho;
+    relatorio->bytes = (long long)info.st_size;
+
+    zerarPicoMemoria();
+
+    // Carga: mediana de algumas construções completas. Com o índice persistente,
+    // cada carga fria começa sem o índice salvo (e o grava de novo), e as cargas
+    // quentes, medidas à parte, o leem.
+    bool persistente = (opcoes & SERIES_INDICE_PERSISTENTE) != 0;
+    std::string indice = std::string(caminho) + PERSISTENCIA_EXTENSAO;
+    std::vector<double> cargas;
+    Series *series = nullptr;
+    for (int c = 0; c < BENCH_CARGAS; c++)
+    {
+        delete series;
+        if (persistente)
+            unlink(indice.c_str());
+        Relogio::time_point comeco = Relogio::now();
+        series = new Series(caminho, opcoes);
+        cargas.push_back(segundosDesde(comeco));
+    }
+    std::sort(cargas.begin(), cargas.end());
+    relatorio->carga = cargas[cargas.size() / 2];
+
+    relatorio->carga_quente = 0;
+    if (persistente)
+    {
+        std::vector<double> quentes;
+        for (int c = 0; c < BENCH_CARGAS; c++)
+        {
+            delete series;
+            Relogio::time_point comeco = Relogio::now();
+            series = new Series(caminho, opcoes);
+            quentes.push_back(segundosDesde(comeco));
+        }
+        std::sort(quentes.begin(), quentes.end());
+        relatorio->carga_quente = quentes[quentes.size() / 2];
+    }
+
+    // Os instantes de todas as linhas: a contagem, os limites e o sorteio das consultas.
+    std::vector<Instante> instantes;
+    Momento todos(Data(MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE),
+                  Horario(MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE));
+    series->ParaCada(todos, todos, [&instantes](const Linha &linha) -> bool
+                     {
+                         instantes.push_back(linha.momento.GetInstante());
+                         return true;
+                     });
+
+    relatorio->linhas = (long long)instantes.size();
+    if (instantes.empty())
+    {
+        delete series;
+        return false;
+    }
+
+    Sorteio sorteio(7);
+    std::vector<double> latencias;
+
+    // Consultas pontuais em momentos existentes.
+    Linha linha;
+    long long encontradas = 0;
+    latencias.reserve(consultas);
+    for (long long c = 0; c < consultas; c++)
+    {
+        Momento momento = Momento::DeInstante(instantes[sorteio.Entre(0, instantes.size() - 1)]);
+
+        Relogio::time_point comeco = Relogio::now();
+        encontradas += series->GetLinha(momento, &linha) ? 1 : 0;
+        latencias.push_back(segundosDesde(comeco));
+    }
+    relatorio->medicoes.push_back(resumir("GetLinha", latencias, encontradas));
+
+    // As mesmas consultas pontuais divididas entre várias threads, todas na mesma série.
+    // Os momentos vêm de outro sorteio, para não mudar os intervalos medidos a seguir.
+    if (threads > 1)
+    {
+        Sorteio sorteio_threads(11);
+        std::vector<Momento> momentos;
+        momentos.reserve(consultas);
+        for (long long c = 0; c < consultas; c++)
+            momentos.push_back(Momento::DeInstante(instantes[sorteio_threads.Entre(0, instantes.size() - 1)]));
+
+        std::vector<std::vector<double>> por_thread(threads);
+        std::atomic<long long> achadas(0);
+        std::vector<std::thread> trabalhadores;
+
+        Relogio::time_point comeco = Relogio::now();
+        for (int t = 0; t < threads; t++)
+        {
+            trabalhadores.emplace_back([&, t]()
+                                       {
+                                           Linha linha;
+                                           long long n = 0;
+                                           for (long long c = t; c < consultas; c += threads)
+                                           {
+                                               Relogio::time_point inicio = Relogio::now();
+                                               n += series->GetLinha(momentos[c], &linha) ? 1 : 0;
+                                               por_thread[t].push_back(segundosDesde(inicio));
+                                           }
+                                           achadas += n;
+                                       });
+        }
+        for (std::thread &trabalhador : trabalhadores)
+            trabalhador.join();
+        double parede = segundosDesde(comeco);
+
+        latencias.clear();
+        for (const std::vector<double> &medidas : por_thread)
+            latencias.insert(latencias.end(), medidas.begin(), medidas.end());
+
+        Medicao medicao = resumir(("GetLinha/" + std::to_string(threads) + "t").c_str(), latencias, achadas);
+        medicao.segundos = parede;
+        relatorio->medicoes.push_back(medicao);
+    }
+
+    // Intervalos de várias larguras, pela lista (GetLinhas) e pelo resumo do rodapé (Agregar).
+    for (const auto &largura : larguras)
+    {
+        long long minutos = largura.horas * 60;
+        long long linhas_por_consulta = largura.horas ? largura.horas : relatorio->linhas;
+        long long quantidade = std::min(consultas, BENCH_LINHAS_POR_LARGURA / linhas_por_consulta);
+        quantidade = std::max<long long>(BENCH_MINIMO_INTERVALOS, quantidade);
+
+        std::vector<std::pair<Momento, Momento>> intervalos;
+        for (long long c = 0; c < quantidade; c++)
+        {
+            if (minutos == 0)
+                intervalos.push_back({todos, todos});
+            else
+            {
+                Instante de = instantes[sorteio.Entre(0, instantes.size() - 1)];
+                intervalos.push_back({Momento::DeInstante(de), Momento::DeInstante(de + minutos - 1)});
+            }
+        }
+
+        long long linhas = 0;
+        latencias.clear();
+        for (const auto &intervalo : intervalos)
+        {
+            Relogio::time_point comeco = Relogio::now();
+            Lista<Linha> lista;
+            series->GetLinhas(intervalo.first, intervalo.second, &lista);
+            latencias.push_back(segundosDesde(comeco));
+            linhas += lista.GetTamanho();
+        }
+        relatorio->medicoes.push_back(resumir((std::string("GetLinhas/") + largura.nome).c_str(), latencias, linhas));
+
+        linhas = 0;
+        latencias.clear();
+        for (const auto &intervalo : intervalos)
+        {
+            Agregado agregados[QUANTIDADE_VARIAVEIS];
+
+            Relogio::time_point comeco = Relogio::now();
+            series->Agregar(intervalo.first, intervalo.second, VARIAVEIS_TODAS, agregados);
+            latencias.push_back(segundosDesde(comeco));
+            linhas += agregados[0].quantidade;
+        }
+        relatorio->medicoes.push_back(resumir((std::string("Agregar/") + largura.nome).c_str(), latencias, linhas));
+    }
+
+    delete series;
+    relatorio->rss_pico = getPicoMemoria();
+    return true;
+}
+
+static void imprimirTexto(const Relatorio &relatorio)
+{
+    printf("\n%s: %lld linhas, %.1f MiB\n", relatorio.arquivo.c_str(), relatorio.linhas, relatorio.bytes / 1048576.0);
+    printf("  carga: %.3f s (%.0f linhas/s, %.1f MiB/s), pico de memória: %.1f MiB\n", relatorio.carga,
+           relatorio.linhas / relatorio.carga, relatorio.bytes / 1048576.0 / relatorio.carga, relatorio.rss_pico / 1024.0);
+    if (relatorio.carga_quente > 0)
+        printf("  carga com o índice salvo: %.3f s (%.0f linhas/s)\n", relatorio.carga_quente,
+               relatorio.linhas / relatorio.carga_quente);
+
+    printf("  %-16s %10s %14s %14s %10s %10s %10s %10s\n", "consulta", "quantidade", "consultas/s", "linhas/s",
+           "p50 us", "p90 us", "p99 us", "max us");
+    for (const Medicao &medicao : relatorio.medicoes)
+    {
+        printf("  %-16s %10lld %14.0f %14.0f %10.1f %10.1f %10.1f %10.1f\n", medicao.nome.c_str(), medicao.consultas,
+               medicao.consultas / medicao.segundos, medicao.linhas / medicao.segundos, medicao.p50 * 1e6,
+               medicao.p90 * 1e6, medicao.p99 * 1e6, medicao.maximo * 1e6);
+    }
+}
+
+static void imprimirJson(const std::vector<Relatorio> &relatorios, int opcoes)
+{
+    printf("{\"opcoes\":%d,\"arquivos\":[", opcoes);
+    for (size_t r = 0; r < relatorios.size(); r++)
+    {
+        const Relatorio &relatorio = relatorios[r];
+        printf("%s\n{\"arquivo\":\"%s\",\"bytes\":%lld,\"linhas\":%lld,\"carga_s\":%.6f,\"carga_quente_s\":%.6f,"
+               "\"rss_pico_kib\":%lld,\"consultas\":[",
+               r ? "," : "", relatorio.arquivo.c_str(), relatorio.bytes, relatorio.linhas, relatorio.carga,
+               relatorio.carga_quente, relatorio.rss_pico);
+
+        for (size_t m = 0; m < relatorio.medicoes.size(); m++)
+        {
+            const Medicao &medicao = relatorio.medicoes[m];
+            printf("%s\n {\"nome\":\"%s\",\"quantidade\":%lld,\"linhas\":%lld,\"segundos\":%.6f,"
+                   "\"p50_us\":%.3f,\"p90_us\":%.3f,\"p99_us\":%.3f,\"max_us\":%.3f}",
+                   m ? "," : "", medicao.nome.c_str(), medicao.consultas, medicao.linhas, medicao.segundos,
+                   medicao.p50 * 1e6, medicao.p90 * 1e6, medicao.p99 * 1e6, medicao.maximo * 1e6);
+        }
+        printf("]}");
+    }
+    printf("]}\n");
+}
+
+static void imprimirUso()
+{
+    fprintf(stderr, "uso: series_bench [opções] [arquivo.csv ...]\n");
+    fprintf(stderr, "  --anos 1,10,50    Anos dos arquivos gerados quando nenhum arquivo é informado.\n");
+    fprintf(stderr, "  --consultas N     Consultas pontuais por arquivo (padrão: %d).\n", BENCH_CONSULTAS_PADRAO);
+    fprintf(stderr, "  --threads N       Mede também as consultas pontuais em N threads na mesma série.\n");
+    fprintf(stderr, "  --json            Resultado em JSON, para comparar versões.\n");
+    fprintf(stderr, "  e as opções de carga do programa: --indice-compacto, --mapear, --paralelo,\n");
+    fprintf(stderr, "  --indice-persistente, --carregar-tudo, --piramide, --indice-sazonal.\n");
+}
+
+/*
+ * Mede a carga de arquivos do INMET e as consultas sobre eles: linhas pontuais,
+ * intervalos de um dia a todo o arquivo, e o resumo usado no rodapé da tabela.
+ * Sem arquivos, gera arquivos sintéticos com a quantidade de anos pedida.
+ */
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> arquivos;
+    const char *anos = BENCH_ANOS_PADRAO;
+    long long consultas = BENCH_CONSULTAS_PADRAO;
+    int threads = 1;
+    bool json = false;
+    int opcoes = SERIES_PADRAO;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool conhecida = false;
+        for (const auto &opcao : opcoes_conhecidas)
+        {
+            if (strcmp(argv[i], opcao.nome) == 0)
+            {
+                opcoes |= opcao.opcao;
+                conhecida = true;
+            }
+        }
+
+        if (conhecida)
+            continue;
+        else if (strcmp(argv[i], "--json") == 0)
+            json = true;
+        else if (strcmp(argv[i], "--anos") == 0 && i + 1 < argc)
+            anos = argv[++i];
+        else if (strcmp(argv[i], "--consultas") == 0 && i + 1 < argc)
+            consultas = atoll(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else if (argv[i][0] != '-')
+            arquivos.push_back(argv[i]);
+        else
+        {
+            imprimirUso();
+            return 1;
+        }
+    }
+
+    // Sem arquivos, geramos um por quantidade de anos, e os apagamos ao final.
+    std::vector<std::string> gerados;
+    if (arquivos.empty())
+    {
+        for (const char *p = anos; *p != '\0';)
+        {
+            int quantidade = atoi(p);
+            if (quantidade > 0)
+            {
+                std::string caminho = "/tmp/series_bench_" + std::to_string(getpid()) + "_" + std::to_string(quantidade) + "anos.csv";
+                if (!GerarArquivo(caminho.c_str(), GetOpcoesGeradorPadrao(quantidade)))
+                {
+                    fprintf(stderr, "não foi possível gerar %s\n", caminho.c_str());
+                    return 1;
+                }
+                gerados.push_back(caminho);
+                arquivos.push_back(caminho);
+            }
+
+            const char *virgula = strchr(p, ',');
+            p = virgula ? virgula + 1 : p + strlen(p);
+        }
+    }
+
+    std::vector<Relatorio> relatorios;
+    int status = 0;
+    for (const std::string &arquivo : arquivos)
+    {
+        Relatorio relatorio;
+        if (!medirArquivo(arquivo.c_str(), opcoes, consultas, threads, &relatorio))
+        {
+            fprintf(stderr, "%s: arquivo sem linhas ou inacessível\n", arquivo.c_str());
+            status = 1;
+            continue;
+        }
+
+        if (!json)
+            imprimirTexto(relatorio);
+        relatorios.push_back(relatorio);
+    }
+
+    if (json)
+        imprimirJson(relatorios, opcoes);
+
+    for (const std::string &caminho : gerados)
+    {
+        unlink(caminho.c_str());
+        unlink((caminho + PERSISTENCIA_EXTENSAO).c_str());
+    }
+
+    return status;
+}
@@ -0,0 +1,74 @@
+#include <simd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// Tamanho do texto sintético analisado (em MiB), se não for informado.
+#define BENCH_TAMANHO_PADRAO 256
+
+/*
+ * Compara a vazão (bytes/segundo) da varredura de delimitadores em cada
+ * implementação disponível, sobre linhas sintéticas no formato do INMET.
+ */
+int main(int argc, char *argv[])
+{
+    size_t megabytes = argc > 1 ? (size_t)atoi(argv[1]) : BENCH_TAMANHO_PADRAO;
+    size_t tamanho = megabytes << 20;
+
+    const char *linha = "2024/01/01;0000 UTC;0;888,2;888,2;887,7;;21,4;17,6;21,9;21,4;17,9;17,5;80;78;79;101;3,5;1,6;\n";
+    size_t tamanho_linha = strlen(linha);
+
+    std::string texto;
+    texto.reserve(tamanho + tamanho_linha);
+    while (texto.size() < tamanho)
+        texto.append(linha, tamanho_linha);
+
+    const char *inicio = texto.data();
+    const char *fim = inicio + texto.size();
+
+    int maximo = SimdGetNivel();
+    // 'mascaras' mede só o cálculo das máscaras; 'varredura' inclui visitar cada delimitador.
+    printf("%-10s %16s %16s %12s %12s\n", "nivel", "mascaras MB/s", "varredura MB/s", "linhas", "campos");
+
+    for (int nivel = SIMD_ESCALAR; nivel <= maximo; nivel++)
+    {
+        SimdDefinirNivel(nivel);
+
+        long long contagem = 0;
+        auto comeco = std::chrono::steady_clock::now();
+
+        for (const char *p = inicio; p + SIMD_TAMANHO_BLOCO <= fim; p += SIMD_TAMANHO_BLOCO)
+        {
+            uint64_t l, c;
+            MascararBloco(p, &l, &c);
+            contagem += __builtin_popcountll(l | c);
+        }
+
+        double mascaras = std::chrono::duration<double>(std::chrono::steady_clock::now() - comeco).count();
+
+        long long linhas = 0, campos = 0;
+        comeco = std::chrono::steady_clock::now();
+
+        Varredor varredor(inicio, fim);
+        for (const char *p = varredor.Proximo(); p < fim; p = varredor.Proximo())
+        {
+            if (*p == '\n')
+                linhas++;
+            else
+                campos++;
+        }
+
+        double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - comeco).count();
+        // Sanidade: as máscaras não podem ver mais delimitadores do que a varredura.
+        if (contagem > linhas + campos)
+            return 1;
+
+        printf("%-10s %16.1f %16.1f %12lld %12lld\n", SimdGetNome(nivel), texto.size() / mascaras / 1e6,
+               texto.size() / segundos / 1e6, linhas, campos);
+    }
+
+    return 0;
+}
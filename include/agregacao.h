@@ -0,0 +1,90 @@
+#ifndef AGREGACAO_H
+#define AGREGACAO_H
+
+#include <limits>
+
+/*
+ * Resumo de uma variável em um intervalo: quantidade de linhas, quantidade de
+ * valores presentes, soma, mínimo e máximo. Valores ausentes (NaN) só entram
+ * na quantidade de linhas.
+ */
+typedef struct Agregado
+{
+    long long quantidade;
+    long long validos;
+    double soma;
+    double minimo;
+    double maximo;
+
+    Agregado()
+    {
+        this->quantidade = 0;
+        this->validos = 0;
+        this->soma = 0;
+        this->minimo = std::numeric_limits<double>::infinity();
+        this->maximo = -std::numeric_limits<double>::infinity();
+    }
+
+    /*
+     * @brief Média dos valores presentes, ou NaN se nenhum valor estava presente.
+     */
+    inline double GetMedia() const
+    {
+        return validos > 0 ? soma / validos : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    /*
+     * @brief Menor valor presente, ou NaN se nenhum valor estava presente.
+     */
+    inline double GetMinimo() const
+    {
+        return validos > 0 ? minimo : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    /*
+     * @brief Maior valor presente, ou NaN se nenhum valor estava presente.
+     */
+    inline double GetMaximo() const
+    {
+        return validos > 0 ? maximo : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    /*
+     * @brief Acrescenta um único valor ao resumo. NaN conta apenas como linha.
+     */
+    inline void Adicionar(double valor)
+    {
+        quantidade++;
+        if (valor != valor)
+            return;
+
+        validos++;
+        soma += valor;
+        if (valor < minimo)
+            minimo = valor;
+        if (valor > maximo)
+            maximo = valor;
+    }
+
+    /*
+     * @brief Soma ao resumo atual o resumo de outro intervalo.
+     */
+    inline void Combinar(const Agregado &outro)
+    {
+        quantidade += outro.quantidade;
+        validos += outro.validos;
+        soma += outro.soma;
+        if (outro.minimo < minimo)
+            minimo = outro.minimo;
+        if (outro.maximo > maximo)
+            maximo = outro.maximo;
+    }
+} Agregado;
+
+/*
+ * @brief Acumula em 'agregado' os valores de uma coluna contígua. Usa AVX2 ou
+ * SSE2 quando disponíveis, com os valores NaN mascarados como ausentes.
+ */
+void AgregarColuna(const double *valores, long long quantidade, Agregado *agregado);
+
+#endif // !AGREGACAO_H
@@ -0,0 +1,147 @@
+#ifndef ALOCADOR_H
+#define ALOCADOR_H
+
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Quantidade de elementos do primeiro bloco de um pool. Cada bloco novo
+// tem o dobro do anterior, até o tamanho máximo.
+#define ALOCADOR_BLOCO_INICIAL 32
+#define ALOCADOR_BLOCO_MAXIMO 65536
+
+/*
+ * Alocadores usados pelos nós de Lista e Arvore. Todos oferecem a mesma interface:
+ *  - Criar(args...): aloca e constrói um elemento;
+ *  - Destruir(elemento): destrói e devolve um único elemento;
+ *  - Liberar(): devolve de uma vez toda a memória do alocador. Os elementos
+ *    precisam ter sido destruídos antes, a não ser que sejam trivialmente destrutíveis;
+ *  - LIBERA_EM_BLOCO: diz se Liberar() dispensa chamar Destruir() em cada elemento.
+ */
+
+/*
+ * Pool de elementos alocados em blocos grandes e contíguos. Os elementos
+ * destruídos são reaproveitados pelas próximas criações, e toda a memória
+ * é devolvida de uma só vez em Liberar() ou na destruição do pool.
+ */
+template <typename T>
+class AlocadorPool
+{
+private:
+    // Um espaço livre guarda o próximo espaço livre no lugar do elemento.
+    union Espaco
+    {
+        Espaco *proximo;
+        alignas(T) unsigned char dados[sizeof(T)];
+    };
+
+    std::vector<std::unique_ptr<Espaco[]>> blocos;
+    Espaco *livres = nullptr;
+
+    // Espaços já entregues do último bloco, e a capacidade dele.
+    size_t usados = 0;
+    size_t capacidade = 0;
+
+    Espaco *reservar()
+    {
+        if (livres != nullptr)
+        {
+            Espaco *espaco = livres;
+            livres = espaco->proximo;
+            return espaco;
+        }
+
+        if (usados == capacidade)
+        {
+            capacidade = capacidade == 0 ? ALOCADOR_BLOCO_INICIAL : capacidade * 2;
+            if (capacidade > ALOCADOR_BLOCO_MAXIMO)
+                capacidade = ALOCADOR_BLOCO_MAXIMO;
+
+            blocos.emplace_back(new Espaco[capacidade]);
+            usados = 0;
+        }
+
+        return &blocos.back()[usados++];
+    }
+
+public:
+    static constexpr bool LIBERA_EM_BLOCO = true;
+
+    AlocadorPool() = default;
+
+    AlocadorPool(const AlocadorPool &) = delete;
+    AlocadorPool &operator=(const AlocadorPool &) = delete;
+
+    AlocadorPool(AlocadorPool &&outro) noexcept
+        : blocos(std::move(outro.blocos)), livres(outro.livres), usados(outro.usados), capacidade(outro.capacidade)
+    {
+        outro.livres = nullptr;
+        outro.usados = 0;
+        outro.capacidade = 0;
+    }
+
+    AlocadorPool &operator=(AlocadorPool &&outro) noexcept
+    {
+        if (this != &outro)
+        {
+            blocos = std::move(outro.blocos);
+            livres = std::exchange(outro.livres, nullptr);
+            usados = std::exchange(outro.usados, 0);
+            capacidade = std::exchange(outro.capacidade, 0);
+        }
+        return *this;
+    }
+
+    template <typename... Argumentos>
+    T *Criar(Argumentos &&...argumentos)
+    {
+        Espaco *espaco = reservar();
+        return new (espaco->dados) T{std::forward<Argumentos>(argumentos)...};
+    }
+
+    void Destruir(T *elemento)
+    {
+        elemento->~T();
+
+        Espaco *espaco = reinterpret_cast<Espaco *>(elemento);
+        espaco->proximo = livres;
+        livres = espaco;
+    }
+
+    void Liberar()
+    {
+        blocos.clear();
+        blocos.shrink_to_fit();
+        livres = nullptr;
+        usados = 0;
+        capacidade = 0;
+    }
+};
+
+/*
+ * Alocador que usa new/delete para cada elemento. Mantido para comparação.
+ */
+template <typename T>
+class AlocadorNew
+{
+public:
+    static constexpr bool LIBERA_EM_BLOCO = false;
+
+    template <typename... Argumentos>
+    T *Criar(Argumentos &&...argumentos)
+    {
+        return new T{std::forward<Argumentos>(argumentos)...};
+    }
+
+    void Destruir(T *elemento)
+    {
+        delete elemento;
+    }
+
+    void Liberar()
+    {
+    }
+};
+
+#endif // !ALOCADOR_H
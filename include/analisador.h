@@ -0,0 +1,166 @@
+#ifndef ANALISADOR_H
+#define ANALISADOR_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <momento.h>
+
+/*
+ * Funções de interpretação dos campos de uma linha do INMET, feitas direto sobre
+ * o buffer de caracteres. Nenhuma delas aloca memória ou depende do locale.
+ */
+
+// Valor que o INMET usa para indicar uma medição ausente.
+#define ANALISADOR_AUSENTE "-9999"
+
+// Maior mantissa que um double representa sem perder precisão (2^53).
+#define ANALISADOR_MANTISSA_EXATA 9007199254740992ULL
+
+/*
+ * @brief Lê exatamente 'n' dígitos decimais a partir de 'p'.
+ * @return false se algum dos caracteres não for um dígito.
+ */
+inline bool AnalisarDigitos(const char *p, int n, int *valor)
+{
+    int v = 0;
+    for (int i = 0; i < n; i++)
+    {
+        unsigned d = (unsigned)(p[i] - '0');
+        if (d > 9)
+            return false;
+        v = v * 10 + (int)d;
+    }
+    *valor = v;
+    return true;
+}
+
+/*
+ * @brief Interpreta uma data no formato "AAAA/MM/DD" (ou "AAAA-MM-DD").
+ * @return false se algum campo não é numérico, ou o mês e o dia não existem.
+ */
+inline bool AnalisarData(const char *p, const char *fim, Data *data)
+{
+    if (fim - p < 10)
+        return false;
+
+    if (!AnalisarDigitos(p, 4, &data->ano) ||
+        !AnalisarDigitos(p + 5, 2, &data->mes) ||
+        !AnalisarDigitos(p + 8, 2, &data->dia))
+        return false;
+
+    // Datas impossíveis virariam instantes de outros dias no índice.
+    return data->mes >= 1 && data->mes <= 12 && data->dia >= 1 && data->dia <= DiasNoMes(data->mes, data->ano);
+}
+
+/*
+ * @brief Interpreta um horário no formato "HHMM UTC" (ou "HH:MM").
+ * @return false se algum campo não é numérico, ou a hora e o minuto não existem.
+ */
+inline bool AnalisarHorario(const char *p, const char *fim, Horario *horario)
+{
+    if (fim - p < 4)
+        return false;
+
+    if (!AnalisarDigitos(p, 2, &horario->hora))
+        return false;
+
+    if (p[2] == ':')
+    {
+        if (fim - p < 5)
+            return false;
+        p++;
+    }
+
+    if (!AnalisarDigitos(p + 2, 2, &horario->minuto))
+        return false;
+
+    return horario->hora <= 23 && horario->minuto <= 59;
+}
+
+/*
+ * @brief Interpreta um número decimal com vírgula (ou ponto), como "-12,5".
+ */
+inline bool AnalisarDecimal(const char *p, const char *fim, double *valor)
+{
+    // Potências de 10 exatas em double.
+    static const double potencias[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+                                       1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18};
+
+    const char *inicio = p;
+    bool negativo = false;
+    if (p < fim && (*p == '-' || *p == '+'))
+    {
+        negativo = *p == '-';
+        p++;
+    }
+
+    uint64_t mantissa = 0;
+    int digitos = 0, casas = 0;
+    bool fracao = false;
+
+    for (; p < fim; p++)
+    {
+        unsigned d = (unsigned)(*p - '0');
+        if (d <= 9)
+        {
+            mantissa = mantissa * 10 + d;
+            digitos++;
+            if (fracao)
+                casas++;
+        }
+        else if ((*p == ',' || *p == '.') && !fracao)
+            fracao = true;
+        else
+            break; // Como no strtod, o que sobrar no campo (ex: '\r') é ignorado.
+
+        if (digitos > 18)
+            break;
+    }
+
+    if (digitos == 0)
+        return false;
+
+    if (digitos > 18 || mantissa > ANALISADOR_MANTISSA_EXATA)
+    {
+        // Números fora do caso comum: recorremos ao strtod em uma cópia com ponto.
+        char token[64];
+        size_t tamanho = (size_t)(fim - inicio);
+        if (tamanho >= sizeof(token))
+            return false;
+
+        memcpy(token, inicio, tamanho);
+        token[tamanho] = '\0';
+
+        char *virgula = (char *)memchr(token, ',', tamanho);
+        if (virgula != nullptr)
+            *virgula = '.';
+
+        *valor = strtod(token, nullptr);
+        return true;
+    }
+
+    // Mantissa e potência exatas: a divisão resulta no mesmo valor do strtod.
+    double v = (double)mantissa / potencias[casas];
+    *valor = negativo ? -v : v;
+    return true;
+}
+
+/*
+ * @brief Interpreta um campo de valor, já delimitado, da linha.
+ * Campos vazios ou com -9999 recebem 'ausente'.
+ */
+inline bool AnalisarValor(const char *campo, const char *fim, double ausente, double *valor)
+{
+    size_t tamanho = fim - campo;
+    if (tamanho == 0 || (tamanho == 5 && memcmp(campo, ANALISADOR_AUSENTE, 5) == 0))
+    {
+        *valor = ausente;
+        return true;
+    }
+
+    return AnalisarDecimal(campo, fim, valor);
+}
+
+#endif // !ANALISADOR_H
@@ -1,10 +1,16 @@
 #ifndef ARVORE_H
 #define ARVORE_H
 
+#include <alocador.h>
 #include <lista.h>
 #include <functional>
+#include <type_traits>
 
-template <typename Chave, typename Valor>
+// Altura máxima suportada por uma árvore AVL. Uma AVL com altura 64 precisaria de
+// mais nós do que cabem em memória, então o caminho sempre cabe nesse limite.
+#define ARVORE_ALTURA_MAXIMA 64
+
+template <typename Chave, typename Valor, template <typename> class Alocador = AlocadorPool>
 class Arvore
 {
 public:
@@ -16,6 +22,9 @@ public:
 
         struct No *esquerda;
         struct No *direita;
+
+        // Altura da sub-árvore enraizada neste nó (folha = 1).
+        int altura;
     } No;
 
     /*
@@ -25,152 +34,184 @@ public:
     typedef std::function<bool(Chave)> ArvoreComparador;
     typedef std::function<int(Chave&,Chave&)> ArvoreBuscador;
 
+    /*
+     * @brief Função chamada para cada nó visitado em ordem. Retornar false
+     * interrompe o percurso.
+     */
+    typedef std::function<bool(No*)> ArvoreVisitante;
+
 private:
     No *raiz;
+    Alocador<No> alocador;
 
     /**
-     * @brief Insere recursivamente um novo nó na sub-árvore.
+     * @brief Retorna a altura de um nó, considerando nulo como altura 0.
      */
-    No *inserirRecursivo(No *no, Chave &chave, Valor &valor)
+    static int altura(No *no)
     {
-        if (no == nullptr)
-            return new No{chave, valor, nullptr, nullptr};
-
-        if (chave < no->chave)
-            no->esquerda = inserirRecursivo(no->esquerda, chave, valor);
-        else if (chave > no->chave)
-            no->direita = inserirRecursivo(no->direita, chave, valor);
-        else
-            // Se a chave já existe, apenas atualizamos o valor.
-            no->valor = valor;
-
-        return no;
+        return no == nullptr ? 0 : no->altura;
     }
 
     /**
-     * @brief Busca recursivamente por um nó com a chave especificada.
+     * @brief Recalcula a altura de um nó a partir dos seus filhos.
      */
-    No *buscarRecursivo(No *no, Chave &chave)
+    static void atualizarAltura(No *no)
     {
-        // Chave não encontrada.
-        if (no == nullptr)
-            return no;
-
-        if (chave < no->chave)
-            return buscarRecursivo(no->esquerda, chave);
-        else if (chave > no->chave)
-            return buscarRecursivo(no->direita, chave);
-        else
-            return no;
+        int e = altura(no->esquerda);
+        int d = altura(no->direita);
+        no->altura = (e > d ? e : d) + 1;
     }
 
     /**
-     * @brief Busca recursivamente por um nó com a chave especificada e comparador especificado.
+     * @brief Rotaciona a sub-árvore para a direita e retorna a nova raiz dela.
      */
-    No *buscarRecursivo(No *no, Chave &chave, ArvoreBuscador comparador)
+    static No *rotacionarDireita(No *no)
     {
-        if (no == nullptr)
-            return no;
+        No *nova = no->esquerda;
+        no->esquerda = nova->direita;
+        nova->direita = no;
 
-        int comp = comparador(chave, no->chave);
-        if (comp > 0)
-            return buscarRecursivo(no->direita, chave);
-        else if (comp < 0)
-            return buscarRecursivo(no->esquerda, chave);
-        else
-            return no;
+        atualizarAltura(no);
+        atualizarAltura(nova);
+        return nova;
     }
 
     /**
-     * @brief Encontra o nó com a menor chave na sub-árvore (o mais à esquerda).
+     * @brief Rotaciona a sub-árvore para a esquerda e retorna a nova raiz dela.
      */
-    No *encontrarMenor(No *no)
+    static No *rotacionarEsquerda(No *no)
     {
-        No *atual = no;
-        while (atual && atual->esquerda != nullptr)
-            atual = atual->esquerda;
+        No *nova = no->direita;
+        no->direita = nova->esquerda;
+        nova->esquerda = no;
 
-        return atual;
+        atualizarAltura(no);
+        atualizarAltura(nova);
+        return nova;
     }
 
     /**
-     * @brief Remove de maneira recursiva um nó com a chave especificada.
+     * @brief Restaura a propriedade AVL de um nó e retorna a nova raiz da sub-árvore.
      */
-    No *removerRecursivo(No *no, Chave &chave)
+    static No *balancear(No *no)
     {
-        if (no == nullptr)
-            return no; // Chave não encontrada.
+        atualizarAltura(no);
+        int fator = altura(no->esquerda) - altura(no->direita);
 
-        // Navega até o nó a ser removido.
-        if (chave < no->chave)
-            no->esquerda = removerRecursivo(no->esquerda, chave);
-        else if (chave > no->chave)
-            no->direita = removerRecursivo(no->direita, chave);
-
-        else
+        if (fator > 1)
         {
-            // Nó com a chave encontrado.
-            if (no->esquerda == nullptr)
-            {
-                No *temp = no->direita;
-                delete no;
-                return temp;
-            }
-            else if (no->direita == nullptr)
-            {
-                No *temp = no->esquerda;
-                delete no;
-                return temp;
-            }
-
-            No *temp = encontrarMenor(no->direita);
-
-            no->chave = temp->chave;
-            no->valor = temp->valor;
+            if (altura(no->esquerda->esquerda) < altura(no->esquerda->direita))
+                no->esquerda = rotacionarEsquerda(no->esquerda);
+            return rotacionarDireita(no);
+        }
 
-            no->direita = removerRecursivo(no->direita, temp->chave);
+        if (fator < -1)
+        {
+            if (altura(no->direita->direita) < altura(no->direita->esquerda))
+                no->direita = rotacionarDireita(no->direita);
+            return rotacionarEsquerda(no);
         }
+
         return no;
     }
 
     /**
-     * @brief Destrói (desaloca) a árvore recursivamente em pós-ordem.
+     * @brief Rebalanceia, de baixo para cima, todos os nós do caminho percorrido,
+     * religando cada sub-árvore ao seu pai.
      */
-    void destruirRecursivo(No *no)
+    void rebalancearCaminho(No **caminho, int tamanho)
     {
-        if (no != nullptr)
+        for (int i = tamanho - 1; i >= 0; i--)
         {
-            destruirRecursivo(no->esquerda);
-            destruirRecursivo(no->direita);
-            delete no;
+            No *original = caminho[i];
+            No *balanceado = balancear(original);
+
+            if (i == 0)
+                raiz = balanceado;
+            else if (caminho[i - 1]->esquerda == original)
+                caminho[i - 1]->esquerda = balanceado;
+            else
+                caminho[i - 1]->direita = balanceado;
         }
     }
 
-    void listarRecursivo(No* no, Lista<No*>* l, ArvoreComparador* b) {
-        if(no != nullptr) {
-            listarRecursivo(no->esquerda, l, b);
-
-            if((*b)(no->chave))
-                l->Inserir(no);
-
-            listarRecursivo(no->direita, l, b);
-        }
+    /**
+     * @brief Monta uma sub-árvore com as chaves de [inicio, fim), tendo a do meio
+     * como raiz, e retorna a raiz dela. As metades diferem em no máximo um nó, então
+     * a sub-árvore já sai balanceada.
+     */
+    No *construir(const Chave *chaves, const Valor *valores, size_t inicio, size_t fim)
+    {
+        if (inicio == fim)
+            return nullptr;
+
+        size_t meio = inicio + (fim - inicio) / 2;
+        No *no = alocador.Criar(chaves[meio], valores[meio], nullptr, nullptr, 1);
+        no->esquerda = construir(chaves, valores, inicio, meio);
+        no->direita = construir(chaves, valores, meio + 1, fim);
+        atualizarAltura(no);
+        return no;
     }
 
 public:
     Arvore() : raiz(nullptr) {}
     ~Arvore()
     {
-        destruirRecursivo(raiz);
+        Limpar();
     }
 
-    /** 
+    /**
+     * Evitamos que cópias surjam da nossa árvore.
+     */
+    Arvore(const Arvore &) = delete;
+    Arvore &operator=(const Arvore &) = delete;
+
+    /**
     * @brief Faz a inserção de um novo nó na árvore.
     */
     No *Inserir(Chave &chave, Valor &valor)
     {
-        raiz = inserirRecursivo(raiz, chave, valor);
-        return Buscar(chave); // Retorna o nó para consistência.
+        No *caminho[ARVORE_ALTURA_MAXIMA];
+        int tamanho = 0;
+
+        No *atual = raiz;
+        while (atual != nullptr)
+        {
+            if (chave < atual->chave)
+            {
+                caminho[tamanho++] = atual;
+                atual = atual->esquerda;
+            }
+            else if (chave > atual->chave)
+            {
+                caminho[tamanho++] = atual;
+                atual = atual->direita;
+            }
+            else
+            {
+                // Se a chave já existe, apenas atualizamos o valor.
+                atual->valor = valor;
+                return atual;
+            }
+        }
+
+        No *novo = alocador.Criar(chave, valor, nullptr, nullptr, 1);
+
+        if (tamanho == 0)
+        {
+            raiz = novo;
+            return novo;
+        }
+
+        No *pai = caminho[tamanho - 1];
+        if (chave < pai->chave)
+            pai->esquerda = novo;
+        else
+            pai->direita = novo;
+
+        // As rotações não trocam a identidade do nó inserido, então o retorno segue válido.
+        rebalancearCaminho(caminho, tamanho);
+        return novo;
     }
 
     /**
@@ -178,7 +219,57 @@ public:
      */
     void Remover(Chave &chave)
     {
-        raiz = removerRecursivo(raiz, chave);
+        No *caminho[ARVORE_ALTURA_MAXIMA];
+        int tamanho = 0;
+
+        No *atual = raiz;
+        while (atual != nullptr)
+        {
+            if (chave < atual->chave)
+            {
+                caminho[tamanho++] = atual;
+                atual = atual->esquerda;
+            }
+            else if (chave > atual->chave)
+            {
+                caminho[tamanho++] = atual;
+                atual = atual->direita;
+            }
+            else
+                break;
+        }
+
+        if (atual == nullptr)
+            return; // Chave não encontrada.
+
+        // Com dois filhos, trocamos o conteúdo pelo sucessor e removemos o sucessor.
+        if (atual->esquerda != nullptr && atual->direita != nullptr)
+        {
+            caminho[tamanho++] = atual;
+
+            No *sucessor = atual->direita;
+            while (sucessor->esquerda != nullptr)
+            {
+                caminho[tamanho++] = sucessor;
+                sucessor = sucessor->esquerda;
+            }
+
+            atual->chave = sucessor->chave;
+            atual->valor = sucessor->valor;
+            atual = sucessor;
+        }
+
+        No *filho = atual->esquerda != nullptr ? atual->esquerda : atual->direita;
+
+        if (tamanho == 0)
+            raiz = filho;
+        else if (caminho[tamanho - 1]->esquerda == atual)
+            caminho[tamanho - 1]->esquerda = filho;
+        else
+            caminho[tamanho - 1]->direita = filho;
+
+        alocador.Destruir(atual);
+        rebalancearCaminho(caminho, tamanho);
     }
 
     /**
@@ -186,12 +277,107 @@ public:
      */
     No *Buscar(Chave &chave)
     {
-        return buscarRecursivo(raiz, chave);
+        No *atual = raiz;
+        while (atual != nullptr)
+        {
+            if (chave < atual->chave)
+                atual = atual->esquerda;
+            else if (chave > atual->chave)
+                atual = atual->direita;
+            else
+                return atual;
+        }
+
+        // Chave não encontrada.
+        return nullptr;
     }
 
     No *Buscar(Chave &chave, ArvoreBuscador buscador)
     {
-        return buscarRecursivo(raiz, chave, buscador);
+        No *atual = raiz;
+        while (atual != nullptr)
+        {
+            int comp = buscador(chave, atual->chave);
+            if (comp > 0)
+                atual = atual->direita;
+            else if (comp < 0)
+                atual = atual->esquerda;
+            else
+                return atual;
+        }
+
+        return nullptr;
+    }
+
+    /**
+    * @brief Visita todos os nós, em ordem, sem montar uma lista.
+    * @return false se o visitante interrompeu o percurso.
+    */
+    bool ParaCada(ArvoreVisitante visitante) {
+        // Percurso em-ordem com pilha explícita.
+        No *pilha[ARVORE_ALTURA_MAXIMA];
+        int topo = 0;
+
+        No *atual = raiz;
+        while (atual != nullptr || topo > 0)
+        {
+            while (atual != nullptr)
+            {
+                pilha[topo++] = atual;
+                atual = atual->esquerda;
+            }
+
+            atual = pilha[--topo];
+            if (!visitante(atual))
+                return false;
+
+            atual = atual->direita;
+        }
+
+        return true;
+    }
+
+    /**
+    * @brief Visita, em ordem, os nós com chave dentro do intervalo [de, ate].
+    * Sub-árvores inteiramente fora do intervalo não são visitadas.
+    * @return false se o visitante interrompeu o percurso.
+    */
+    bool ParaCadaIntervalo(Chave &de, Chave &ate, ArvoreVisitante visitante) {
+        No *pilha[ARVORE_ALTURA_MAXIMA];
+        int topo = 0;
+
+        No *atual = raiz;
+        while (atual != nullptr || topo > 0)
+        {
+            while (atual != nullptr)
+            {
+                // Nó antes do início: ele e toda a sua esquerda ficam de fora.
+                if (atual->chave < de)
+                {
+                    atual = atual->direita;
+                    continue;
+                }
+
+                pilha[topo++] = atual;
+                atual = atual->esquerda;
+            }
+
+            if (topo == 0)
+                break;
+
+            atual = pilha[--topo];
+
+            // Em ordem, todos os próximos nós também passam do fim.
+            if (atual->chave > ate)
+                break;
+
+            if (!visitante(atual))
+                return false;
+
+            atual = atual->direita;
+        }
+
+        return true;
     }
 
     /**
@@ -199,10 +385,78 @@ public:
     */
     Lista<No*> Listar(ArvoreComparador comparador) {
         Lista<No*> lista;
-        listarRecursivo(raiz, &lista, &comparador);
+
+        ParaCada([&](No *no) -> bool
+                 {
+                     if (comparador(no->chave))
+                         lista.Inserir(no);
+                     return true;
+                 });
+
+        return lista;
+    }
+
+    /**
+    * @brief Lista, em ordem, os itens com chave dentro do intervalo [de, ate].
+    */
+    Lista<No*> ListarIntervalo(Chave &de, Chave &ate) {
+        Lista<No*> lista;
+
+        ParaCadaIntervalo(de, ate, [&](No *no) -> bool
+                          {
+                              lista.Inserir(no);
+                              return true;
+                          });
+
         return lista;
     }
 
+    /**
+    * @brief Substitui o conteúdo da árvore por chaves em ordem estritamente crescente,
+    * em O(n), sem a busca e o rebalanceamento de cada inserção.
+    */
+    void Construir(const Chave *chaves, const Valor *valores, size_t quantidade)
+    {
+        Limpar();
+        raiz = construir(chaves, valores, 0, quantidade);
+    }
+
+    /**
+    * @brief Destrói (desaloca) todos os nós da árvore.
+    */
+    void Limpar()
+    {
+        // Nós sem destrutor, em um alocador de blocos, são liberados todos de uma vez.
+        if (Alocador<No>::LIBERA_EM_BLOCO && std::is_trivially_destructible<No>::value)
+        {
+            alocador.Liberar();
+            raiz = nullptr;
+            return;
+        }
+
+        // Achatamos a árvore com rotações à direita, assim cada nó é liberado
+        // sem precisar de pilha ou recursão.
+        No *atual = raiz;
+        while (atual != nullptr)
+        {
+            if (atual->esquerda != nullptr)
+            {
+                No *esquerda = atual->esquerda;
+                atual->esquerda = esquerda->direita;
+                esquerda->direita = atual;
+                atual = esquerda;
+            }
+            else
+            {
+                No *direita = atual->direita;
+                alocador.Destruir(atual);
+                atual = direita;
+            }
+        }
+        alocador.Liberar();
+        raiz = nullptr;
+    }
+
     /**
     * @brief Retorna a raiz da árvore
     */
@@ -211,6 +465,17 @@ public:
         return this->raiz;
     }
 
+    /**
+    * @brief Retorna o nó de maior chave, ou nulo se a árvore está vazia.
+    */
+    No *GetMaior()
+    {
+        No *atual = raiz;
+        while (atual != nullptr && atual->direita != nullptr)
+            atual = atual->direita;
+        return atual;
+    }
+
     /**
     * @brief Retorna se a árvore está vazia.
     */
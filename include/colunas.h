@@ -0,0 +1,108 @@
+#ifndef COLUNAS_H
+#define COLUNAS_H
+
+#include <vector>
+
+#include <momento.h>
+
+// Quantidade de variáveis meteorológicas em cada linha do INMET.
+#define QUANTIDADE_VARIAVEIS 17
+
+// Índice de cada variável, na ordem em que aparecem nos arquivos do INMET.
+#define VARIAVEL_PRECIPITACAO_TOTAL 0
+#define VARIAVEL_PRESSAO_ATMOSFERICA 1
+#define VARIAVEL_PRESSAO_ATMOSFERICA_MAX 2
+#define VARIAVEL_PRESSAO_ATMOSFERICA_MIN 3
+#define VARIAVEL_RADIACAO_GLOBAL 4
+#define VARIAVEL_TEMPERATURA_AR 5
+#define VARIAVEL_TEMPERATURA_ORVALHO 6
+#define VARIAVEL_TEMPERATURA_AR_MAX 7
+#define VARIAVEL_TEMPERATURA_AR_MIN 8
+#define VARIAVEL_TEMPERATURA_ORVALHO_MAX 9
+#define VARIAVEL_TEMPERATURA_ORVALHO_MIN 10
+#define VARIAVEL_UMIDADE_RELATIVA_MAX 11
+#define VARIAVEL_UMIDADE_RELATIVA_MIN 12
+#define VARIAVEL_UMIDADE_RELATIVA 13
+#define VARIAVEL_VENTO_DIRECAO 14
+#define VARIAVEL_VENTO_RAJADA 15
+#define VARIAVEL_VENTO_VELOCIDADE 16
+
+// Máscara com todas as variáveis, para as agregações.
+#define VARIAVEIS_TODAS ((1u << QUANTIDADE_VARIAVEIS) - 1)
+
+/*
+ * Armazenamento em colunas de todas as linhas de uma série: um vetor contíguo
+ * por variável, mais o vetor de instantes. As linhas ficam em ordem cronológica.
+ */
+class Colunas
+{
+private:
+    std::vector<Instante> instantes;
+    std::vector<double> valores[QUANTIDADE_VARIAVEIS];
+
+public:
+    Colunas() = default;
+
+    /*
+     * @brief Reserva espaço para a quantidade de linhas informada.
+     */
+    void Reservar(long long quantidade);
+
+    /*
+     * @brief Adiciona uma linha no fim das colunas. As linhas precisam ser
+     * adicionadas em ordem cronológica.
+     * @param valores: as variáveis da linha, na ordem dos arquivos do INMET.
+     */
+    void Adicionar(const Momento &momento, const double *valores);
+
+    /*
+     * @brief Troca os valores da última linha, mantendo o instante.
+     * @param valores: as variáveis da linha, na ordem dos arquivos do INMET.
+     */
+    void SubstituirUltima(const double *valores);
+
+    /*
+     * @brief Remove todas as linhas.
+     */
+    void Limpar();
+
+    /*
+     * @brief Primeira linha com instante maior ou igual ao informado.
+     */
+    long long LimiteInferior(Instante instante) const;
+
+    /*
+     * @brief Primeira linha com instante maior que o informado.
+     */
+    long long LimiteSuperior(Instante instante) const;
+
+    /*
+     * @brief Retorna a coluna contígua de uma variável.
+     */
+    inline const double *GetColuna(int variavel) const
+    {
+        return this->valores[variavel].data();
+    }
+
+    inline Instante GetInstante(long long linha) const
+    {
+        return this->instantes[linha];
+    }
+
+    inline Momento GetMomento(long long linha) const
+    {
+        return Momento::DeInstante(this->instantes[linha]);
+    }
+
+    inline long long GetQuantidade() const
+    {
+        return (long long)this->instantes.size();
+    }
+
+    inline bool IsVazio() const
+    {
+        return this->instantes.empty();
+    }
+};
+
+#endif // !COLUNAS_H
@@ -0,0 +1,77 @@
+#ifndef CONSULTA_H
+#define CONSULTA_H
+
+#include <saida.h>
+#include <serie.h>
+
+// Tipos de consulta.
+#define CONSULTA_LINHA 0
+#define CONSULTA_LINHAS 1
+#define CONSULTA_RESUMO 2
+
+// Formatos de saída das consultas.
+#define FORMATO_CSV 0
+#define FORMATO_JSON 1
+
+// Casas decimais da soma e da média dos resumos. A ordem das somas muda conforme
+// o modo de carga (ex: com a pirâmide), e o arredondamento esconde essa diferença.
+#define CONSULTA_CASAS_RESUMO 4
+
+/*
+ * Consulta textual, uma por linha:
+ *
+ *     linha  <momento>             primeira linha que combina com o momento
+ *     linhas <de> [<ate>]          todas as linhas do intervalo
+ *     resumo <de> [<ate>]          resumo de cada variável no intervalo
+ *
+ * Um momento é escrito como "ano-mes-diaThora:minuto" (ex: 2024-03-01T12:00).
+ * Qualquer campo pode ser '*' para ser ignorado, e os campos finais podem ser
+ * omitidos (ex: "2024-03", "*-07-*T15"). Sem 'ate', o intervalo é só 'de'.
+ * Linhas vazias ou começando com '#' não são consultas.
+ */
+typedef struct Consulta
+{
+    int tipo;
+    Momento de;
+    Momento ate;
+} Consulta;
+
+/*
+ * @brief Interpreta um momento no formato das consultas.
+ * @return false se o texto não é um momento válido.
+ */
+bool AnalisarMomento(const char *inicio, const char *fim, Momento *momento);
+
+/*
+ * @brief Interpreta uma linha de consulta.
+ * @param erro: recebe a descrição do problema, se a linha for inválida.
+ * @return false se a linha é inválida, ou não é uma consulta (vazia ou comentário,
+ * e nesse caso 'erro' fica nulo).
+ */
+bool AnalisarConsulta(const char *inicio, const char *fim, Consulta *consulta, const char **erro);
+
+/*
+ * @brief Executa uma consulta e escreve o resultado na saída, um registro por linha.
+ *
+ * Em CSV, cada registro começa com o número da consulta e o tipo do registro:
+ *     numero,linha,<momento>,<17 variáveis na ordem do INMET>
+ *     numero,resumo,<variavel>,quantidade,validos,soma,media,minimo,maximo
+ *     numero,vazio                 nenhuma linha combina com a consulta
+ *     numero,erro,mensagem         a leitura parou numa linha ilegível
+ * Valores ausentes ficam vazios.
+ *
+ * Em JSON, cada registro é um objeto em uma linha, com os mesmos campos e
+ * valores ausentes como null.
+ *
+ * @param numero: número da consulta, repetido em cada registro.
+ * @return Quantidade de registros escritos.
+ */
+long long ExecutarConsulta(Series &series, const Consulta &consulta, long long numero, int formato, Saida &saida);
+
+/*
+ * @brief Escreve o registro de erro de uma consulta inválida:
+ * "numero,erro,mensagem" em CSV ou {"consulta":..,"tipo":"erro",..} em JSON.
+ */
+void EscreverErro(long long numero, const char *mensagem, int formato, Saida &saida);
+
+#endif // !CONSULTA_H
@@ -0,0 +1,119 @@
+#ifndef ESTATISTICAS_H
+#define ESTATISTICAS_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+/*
+ * Contadores e cronômetros da carga e das consultas. Com SERIES_ESTATISTICAS
+ * desligada na compilação, as macros abaixo não geram código algum.
+ *
+ * Os valores são globais ao processo e podem ser atualizados por várias
+ * threads ao mesmo tempo (operações atômicas relaxadas).
+ */
+
+// Contadores.
+#define ESTATISTICA_LINHAS_INDEXADAS 0     // linhas adicionadas ao índice
+#define ESTATISTICA_LINHAS_INVALIDAS 1     // linhas não vazias sem data e hora reconhecíveis
+#define ESTATISTICA_LINHAS_DECODIFICADAS 2 // linhas cujos valores foram interpretados
+#define ESTATISTICA_FALHAS_LEITURA 3       // linhas indexadas cujos valores não puderam ser lidos
+#define ESTATISTICA_BYTES_LIDOS 4          // bytes lidos do arquivo pelo fluxo
+#define ESTATISTICA_BYTES_INDEXADOS 5      // bytes varridos pela indexação, por qualquer caminho
+#define ESTATISTICA_SEEKS 6                // leituras do arquivo em uma posição escolhida
+#define QUANTIDADE_CONTADORES 7
+
+// Cronômetros, cada um com um histograma das durações.
+#define TEMPO_INICIALIZAR 0
+#define TEMPO_LER_LINHA 1
+#define TEMPO_GET_LINHA 2
+#define TEMPO_GET_LINHAS 3
+#define TEMPO_PARA_CADA 4
+#define TEMPO_AGREGAR 5
+#define QUANTIDADE_TEMPOS 6
+
+/*
+ * Uma a cada quantas chamadas de cada cronômetro é medida. As medidas valem por
+ * todas as chamadas puladas, então totais e histogramas ficam na escala certa.
+ * LerLinha é chamada por linha, e medir todas as chamadas pesaria nas varreduras.
+ */
+inline constexpr unsigned AMOSTRAGEM_TEMPOS[QUANTIDADE_TEMPOS] = {1, 64, 1, 1, 1, 1};
+
+// Baldes do histograma: o balde b guarda durações entre 2^(b-1) e 2^b - 1 nanossegundos.
+#define ESTATISTICAS_BALDES 48
+
+/*
+ * @brief Soma 'valor' a um contador (ESTATISTICA_*).
+ */
+void EstatisticasSomar(int contador, uint64_t valor);
+
+/*
+ * @brief Registra uma duração, em nanossegundos, em um cronômetro (TEMPO_*).
+ * @param peso: quantas chamadas a medida representa.
+ */
+void EstatisticasRegistrar(int tempo, uint64_t nanossegundos, uint64_t peso = 1);
+
+/*
+ * @brief Diz se as estatísticas foram compiladas (SERIES_ESTATISTICAS).
+ */
+bool EstatisticasAtivas();
+
+/*
+ * @brief Zera todos os contadores e cronômetros.
+ */
+void EstatisticasLimpar();
+
+/*
+ * @brief Imprime os contadores e um resumo de cada cronômetro, para leitura humana.
+ */
+void EstatisticasImprimir(FILE *arquivo);
+
+/*
+ * @brief Escreve todas as estatísticas, com os histogramas completos, em JSON.
+ */
+void EstatisticasImprimirJson(FILE *arquivo);
+
+/*
+ * Mede o tempo de vida do escopo em que foi declarado, seguindo a amostragem
+ * do cronômetro.
+ */
+class CronometroEscopo
+{
+private:
+    int tempo;
+    bool medindo;
+    std::chrono::steady_clock::time_point comeco;
+
+public:
+    explicit CronometroEscopo(int tempo) : tempo(tempo)
+    {
+        static thread_local unsigned chamadas = 0;
+
+        medindo = AMOSTRAGEM_TEMPOS[tempo] == 1 || chamadas++ % AMOSTRAGEM_TEMPOS[tempo] == 0;
+        if (medindo)
+            comeco = std::chrono::steady_clock::now();
+    }
+
+    ~CronometroEscopo()
+    {
+        if (!medindo)
+            return;
+
+        auto duracao = std::chrono::steady_clock::now() - comeco;
+        EstatisticasRegistrar(tempo, (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(duracao).count(),
+                              AMOSTRAGEM_TEMPOS[tempo]);
+    }
+
+    CronometroEscopo(const CronometroEscopo &) = delete;
+    CronometroEscopo &operator=(const CronometroEscopo &) = delete;
+};
+
+#ifdef SERIES_ESTATISTICAS
+#define ESTATISTICA_SOMAR(contador, valor) EstatisticasSomar((contador), (uint64_t)(valor))
+#define ESTATISTICA_TEMPO(tempo) CronometroEscopo cronometro_escopo(tempo)
+#else
+#define ESTATISTICA_SOMAR(contador, valor) ((void)0)
+#define ESTATISTICA_TEMPO(tempo) ((void)0)
+#endif
+
+#endif // !ESTATISTICAS_H
@@ -0,0 +1,95 @@
+#ifndef GERADOR_H
+#define GERADOR_H
+
+#include <cstdint>
+
+// Variantes de formato das linhas geradas, combináveis.
+#define GERADOR_PADRAO 0
+#define GERADOR_DATA_HIFEN 1        // "AAAA-MM-DD" no lugar de "AAAA/MM/DD"
+#define GERADOR_HORA_DOIS_PONTOS 2  // "HH:MM" no lugar de "HHMM UTC"
+#define GERADOR_DECIMAL_PONTO 4     // "12.5" no lugar de "12,5"
+#define GERADOR_LINHAS_VAZIAS 8     // linhas vazias espalhadas pelo arquivo
+#define GERADOR_CRLF 16             // quebras de linha "\r\n"
+#define GERADOR_SEM_QUEBRA_FINAL 32 // última linha sem quebra de linha
+#define GERADOR_MISTURAR 64         // cada linha sorteia as variantes de data, hora e decimal
+
+// Quantidade de variáveis de cada linha, na ordem do INMET.
+#define GERADOR_VARIAVEIS 17
+
+/*
+ * Gerador pseudoaleatório pequeno e determinístico (xorshift64*).
+ */
+class Sorteio
+{
+private:
+    uint64_t estado;
+
+public:
+    explicit Sorteio(uint64_t semente) : estado(semente ? semente : 1) {}
+
+    inline uint64_t Proximo()
+    {
+        estado ^= estado >> 12;
+        estado ^= estado << 25;
+        estado ^= estado >> 27;
+        return estado * 2685821657736338717ULL;
+    }
+
+    /*
+     * @brief Inteiro entre 'minimo' e 'maximo', inclusive.
+     */
+    inline long long Entre(long long minimo, long long maximo)
+    {
+        return minimo + (long long)(Proximo() % (uint64_t)(maximo - minimo + 1));
+    }
+
+    /*
+     * @brief Número em [0, 1).
+     */
+    inline double Fracao()
+    {
+        return (double)(Proximo() >> 11) * (1.0 / 9007199254740992.0);
+    }
+};
+
+/*
+ * Parâmetros de um arquivo sintético no formato do INMET.
+ */
+typedef struct OpcoesGerador
+{
+    // Anos cobertos, de 01/01 do inicial a 31/12 do final, com uma linha por hora.
+    int ano_inicial;
+    int ano_final;
+
+    // Fração dos valores ausentes; metade sai vazia e metade como -9999.
+    double ausentes;
+
+    // Fração aproximada das horas sem linha, em lacunas de até alguns dias.
+    double lacunas;
+
+    // Combinação das variantes GERADOR_*.
+    int variantes;
+
+    // Número da estação, usado no cabeçalho e para variar os valores.
+    int estacao;
+
+    uint64_t semente;
+} OpcoesGerador;
+
+/*
+ * @brief Opções de um arquivo de 'anos' anos terminando em 2024, sem lacunas,
+ * com 5% de valores ausentes e no formato mais recente do INMET.
+ */
+OpcoesGerador GetOpcoesGeradorPadrao(int anos);
+
+/*
+ * @brief Escreve um arquivo no layout que Series::Inicializar espera: 8 linhas
+ * de cabeçalho "CHAVE:;valor", a linha de títulos, e as linhas de dados separadas
+ * por ';'. Os valores são determinísticos para as mesmas opções.
+ * @param linhas: recebe a quantidade de linhas de dados escritas (opcional).
+ * @param bytes: recebe o tamanho do arquivo (opcional).
+ * @return false se o arquivo não pôde ser escrito.
+ */
+bool GerarArquivo(const char *caminho, const OpcoesGerador &opcoes, long long *linhas = nullptr, long long *bytes = nullptr);
+
+#endif // !GERADOR_H
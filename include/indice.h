@@ -0,0 +1,103 @@
+#ifndef INDICE_H
+#define INDICE_H
+
+#include <cstdint>
+#include <vector>
+
+#include <momento.h>
+
+// Maior lacuna (em horas) aceita entre a última hora indexada e uma nova linha.
+// Acima disso o arquivo provavelmente não é horário e o índice compacto desiste.
+#define INDICE_LACUNA_MAXIMA (24 * 366)
+
+/*
+ * Índice compacto de uma série horária. Cada posição do vetor corresponde a
+ * uma hora desde o primeiro momento indexado, e guarda a posição em bytes
+ * da linha no arquivo. Horas ausentes são marcadas em um mapa de bits.
+ */
+class IndiceHorario
+{
+private:
+    // Horas desde 01/01/1970 do primeiro momento indexado.
+    long long base = 0;
+    long long quantidade = 0;
+
+    // As posições usam 32 bits até que algum arquivo passe de 4 GiB.
+    bool largo = false;
+    std::vector<uint32_t> posicoes32;
+    std::vector<uint64_t> posicoes64;
+
+    std::vector<uint64_t> presenca;
+
+    void crescer(long long tamanho);
+
+public:
+    IndiceHorario() = default;
+
+    /*
+     * @brief Indexa a linha de um momento. Só são aceitos momentos completos em
+     * hora cheia, que não estejam antes do primeiro momento indexado.
+     * @return false se o momento não cabe no índice compacto.
+     */
+    bool Inserir(const Momento &momento, uint64_t posicao);
+
+    /*
+     * @brief Busca a posição da linha de um momento completo.
+     * @return false se o momento não foi indexado.
+     */
+    bool Buscar(const Momento &momento, uint64_t *posicao) const;
+
+    /*
+     * @brief Converte um intervalo de momentos completos para o intervalo de horas
+     * do índice, já limitado ao que foi indexado.
+     * @return false se nenhuma hora do índice cai dentro do intervalo.
+     */
+    bool GetIntervalo(const Momento &de, const Momento &ate, long long *primeira, long long *ultima) const;
+
+    /*
+     * @brief Diz se existe uma linha indexada para a hora (relativa ao início).
+     */
+    inline bool IsPresente(long long hora) const
+    {
+        return (presenca[hora >> 6] >> (hora & 63)) & 1;
+    }
+
+    /*
+     * @brief Retorna a posição da linha indexada para a hora (relativa ao início).
+     */
+    inline uint64_t GetPosicao(long long hora) const
+    {
+        return largo ? posicoes64[hora] : posicoes32[hora];
+    }
+
+    /*
+     * @brief Retorna o momento correspondente a uma hora (relativa ao início).
+     */
+    inline Momento GetMomento(long long hora) const
+    {
+        return Momento::DeHoras(base + hora);
+    }
+
+    /*
+     * @brief Quantidade de horas cobertas pelo índice, presentes ou não.
+     */
+    inline long long GetTamanho() const
+    {
+        return largo ? (long long)posicoes64.size() : (long long)posicoes32.size();
+    }
+
+    /*
+     * @brief Quantidade de linhas indexadas.
+     */
+    inline long long GetQuantidade() const
+    {
+        return quantidade;
+    }
+
+    inline bool IsVazio() const
+    {
+        return quantidade == 0;
+    }
+};
+
+#endif // !INDICE_H
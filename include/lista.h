@@ -2,181 +2,117 @@
 #define LISTA_H
 
 #include <functional>
-
+#include <utility>
+#include <vector>
+
+/*
+ * Sequência de valores guardados de forma contígua na memória, na ordem de inserção.
+ * O acesso por índice é O(1) e o percurso é feito com iteradores, como nos
+ * contêineres da biblioteca padrão.
+ */
 template <typename Valor>
 class Lista
 {
 public:
-    struct No
-    {
-        Valor valor;
-        No *proximo;
-    };
+    typedef typename std::vector<Valor>::iterator Iterador;
+    typedef typename std::vector<Valor>::const_iterator IteradorConstante;
 
     // Usado para comparar os valores dentro da nossa lista.
-    typedef std::function<bool(Valor &)> ListaComparador;
+    typedef std::function<bool(const Valor &)> ListaComparador;
 
 private:
-    No *inicio = nullptr;
-    No *fim = nullptr;
-    long long tamanho = 0;
+    std::vector<Valor> valores;
 
 public:
     Lista() = default;
-    ~Lista()
-    {
-        Limpar();
-    }
 
     /**
      * Evitamos que cópias surjam da nossa lista.
      */
     Lista(const Lista &) = delete;
     Lista &operator=(const Lista &) = delete;
-    Lista(Lista &&) = default;
-    Lista &operator=(Lista &&) = default;
+    Lista(Lista &&outra) noexcept = default;
+    Lista &operator=(Lista &&outra) noexcept = default;
 
     /**
-     * @brief Insere um valor dentro da nossa lista.
+     * @brief Reserva espaço para a quantidade de valores informada.
      */
-    No *Inserir(Valor valor)
+    void Reservar(long long quantidade)
     {
-        No *novoNo = new No{valor, nullptr};
-
-        if (IsVazio())
-        {
-            inicio = novoNo;
-            fim = novoNo;
-        }
-        else
-        {
-            fim->proximo = novoNo;
-            fim = novoNo;
-        }
-
-        tamanho++;
-        return novoNo;
+        valores.reserve((size_t)quantidade);
     }
 
     /**
-     * @brief Remove um valor, se existir, da nossa lista
+     * @brief Insere um valor no fim da lista, movendo-o para dentro dela.
      */
-    No *Remover(Valor valor)
+    Valor &Inserir(Valor valor)
     {
-        No *atual = inicio;
-        No *anterior = nullptr;
-
-        while (atual != nullptr && atual->valor != valor)
-        {
-            anterior = atual;
-            atual = atual->proximo;
-        }
-
-        if (atual == nullptr)
-            return nullptr;
-
-        No *proximoDoRemovido = atual->proximo;
-
-        if (anterior == nullptr)
-        {
-            inicio = atual->proximo;
-        }
-        else
-        {
-            anterior->proximo = atual->proximo;
-        }
-
-        if (fim == atual)
-        {
-            fim = anterior;
-        }
-
-        delete atual;
-        tamanho--;
-
-        return proximoDoRemovido;
+        valores.push_back(std::move(valor));
+        return valores.back();
     }
 
-    No *Remover(long long indice)
+    /**
+     * @brief Constrói um valor direto no fim da lista.
+     */
+    template <typename... Argumentos>
+    Valor &Emplace(Argumentos &&...argumentos)
     {
-        if (indice < 0 || indice >= tamanho)
-            return nullptr;
-
-        No *paraRemover = nullptr;
-        tamanho--;
+        valores.emplace_back(std::forward<Argumentos>(argumentos)...);
+        return valores.back();
+    }
 
-        if (indice == 0)
+    /**
+     * @brief Remove o primeiro valor igual ao informado, se existir.
+     * @return false se o valor não foi encontrado.
+     */
+    bool Remover(const Valor &valor)
+    {
+        for (Iterador i = valores.begin(); i != valores.end(); ++i)
         {
-            paraRemover = inicio;
-            inicio = paraRemover->proximo;
-
-            if (inicio == nullptr)
+            if (*i == valor)
             {
-                fim = nullptr;
+                valores.erase(i);
+                return true;
             }
-            delete paraRemover;
-            return inicio;
         }
-
-        No *anterior = inicio;
-        for (long long i = 0; i < indice - 1; ++i)
-        {
-            anterior = anterior->proximo;
-        }
-
-        paraRemover = anterior->proximo;
-        anterior->proximo = paraRemover->proximo;
-
-        if (anterior->proximo == nullptr)
-        {
-            fim = anterior;
-        }
-
-        delete paraRemover;
-        return anterior->proximo;
+        return false;
     }
 
     /**
-     * @brief Busca e retorna o nosso valor, se existir na lista
+     * @brief Remove o valor de uma posição, deslocando os seguintes.
+     * @return false se a posição não existe.
      */
-    No *Buscar(Valor valor) const
+    bool RemoverIndice(long long indice)
     {
-        No *atual = inicio;
-        while (atual != nullptr)
-        {
-            if (atual->valor == valor)
-                return atual;
-            atual = atual->proximo;
-        }
-        return nullptr;
+        if (indice < 0 || indice >= GetTamanho())
+            return false;
+
+        valores.erase(valores.begin() + indice);
+        return true;
     }
 
     /**
-     * @brief Busca por um valor atráves do indice de posição dela.
+     * @brief Busca e retorna o nosso valor, se existir na lista.
      */
-    No *Buscar(long long indice) const
+    Valor *Buscar(const Valor &valor)
     {
-        if (indice < 0 || indice >= tamanho)
-            return nullptr;
-
-        No *atual = inicio;
-        for (long long i = 0; i < indice; ++i)
-            atual = atual->proximo;
-
-        return atual;
+        for (Valor &v : valores)
+        {
+            if (v == valor)
+                return &v;
+        }
+        return nullptr;
     }
 
     /**
      * @brief Busca por um valor, dado um critério 'condicao'.
      */
-    No *Buscar(ListaComparador condicao)
+    Valor *Buscar(ListaComparador condicao)
     {
-        No *atual = inicio;
-        while (atual != nullptr)
+        for (Valor &v : valores)
         {
-            if (condicao(atual->valor))
-                return atual;
-            atual = atual->proximo;
+            if (condicao(v))
+                return &v;
         }
         return nullptr;
     }
@@ -184,43 +120,66 @@ public:
     /**
      * @brief Lista todos os itens dado uma 'condicao'.
      */
-    Lista<Valor> Listar(ListaComparador condicao)
+    Lista<Valor> Listar(ListaComparador condicao) const
     {
         Lista<Valor> lista;
 
-        No *atual = inicio;
-        while (atual != nullptr)
+        for (const Valor &v : valores)
         {
-            if (condicao(atual->valor))
-                lista.Inserir(atual);
-            atual = atual->proximo;
+            if (condicao(v))
+                lista.Inserir(v);
         }
 
         return lista;
     }
 
     /**
-     * @brief Retorna o início da lista encadeada.
+     * @brief Acesso ao valor de uma posição, sem verificação de limites.
      */
-    No *GetInicio() const
+    inline Valor &operator[](long long indice)
     {
-        return this->inicio;
+        return valores[(size_t)indice];
+    }
+
+    inline const Valor &operator[](long long indice) const
+    {
+        return valores[(size_t)indice];
+    }
+
+    inline Iterador begin()
+    {
+        return valores.begin();
+    }
+
+    inline Iterador end()
+    {
+        return valores.end();
+    }
+
+    inline IteradorConstante begin() const
+    {
+        return valores.begin();
+    }
+
+    inline IteradorConstante end() const
+    {
+        return valores.end();
     }
 
     /**
      * @brief Retorna o tamanho da lista.
      */
-    long long GetTamanho() const
+    inline long long GetTamanho() const
     {
-        return this->tamanho;
+        return (long long)valores.size();
     }
 
     /**
     * @brief Diz se a lista está vazia.
     */
-    bool IsVazio() const
+    inline bool IsVazio() const
     {
-        return tamanho == 0;
+        return valores.empty();
     }
 
     /**
@@ -228,17 +187,9 @@ public:
     */
     void Limpar()
     {
-        No *atual = inicio;
-        while (atual != nullptr)
-        {
-            No *proximo = atual->proximo;
-            delete atual;
-            atual = proximo;
-        }
-        inicio = nullptr;
-        fim = nullptr;
-        tamanho = 0;
+        valores.clear();
+        valores.shrink_to_fit();
     }
 };
 
-#endif // !LISTA_H
\ No newline at end of file
+#endif // !LISTA_H
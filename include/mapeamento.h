@@ -0,0 +1,66 @@
+#ifndef MAPEAMENTO_H
+#define MAPEAMENTO_H
+
+#include <cstddef>
+
+/*
+ * Mapeamento somente-leitura de um arquivo inteiro em memória.
+ * Enquanto aberto, o conteúdo pode ser lido por vários leitores ao mesmo tempo.
+ *
+ * O mapeamento é compartilhado com o arquivo: crescer não o afeta, mas ler uma
+ * página que ficou depois do fim de um arquivo truncado gera SIGBUS. Quem lê um
+ * arquivo que pode encolher chama Conferir antes das leituras.
+ */
+class Mapeamento
+{
+private:
+    const char *dados = nullptr;
+    size_t tamanho = 0;
+
+    // Mantido aberto para conferir o tamanho atual do arquivo.
+    int descritor = -1;
+
+public:
+    Mapeamento() = default;
+    ~Mapeamento();
+
+    /**
+     * Evitamos que cópias surjam do nosso mapeamento.
+     */
+    Mapeamento(const Mapeamento &) = delete;
+    Mapeamento &operator=(const Mapeamento &) = delete;
+
+    /*
+     * @brief Mapeia o arquivo informado, desfazendo um mapeamento anterior.
+     * @return false se o arquivo não pôde ser aberto ou mapeado.
+     */
+    bool Abrir(const char *arquivo);
+
+    /*
+     * @brief Confere se o arquivo ainda cobre todo o mapeamento (uma chamada a fstat).
+     * @return false se o arquivo encolheu, e ler o mapeamento não é mais seguro.
+     */
+    bool Conferir() const;
+
+    /*
+     * @brief Desfaz o mapeamento atual, se existir.
+     */
+    void Fechar();
+
+    inline const char *GetDados() const
+    {
+        return this->dados;
+    }
+
+    inline size_t GetTamanho() const
+    {
+        return this->tamanho;
+    }
+
+    inline bool IsAberto() const
+    {
+        return this->dados != nullptr;
+    }
+};
+
+#endif // !MAPEAMENTO_H
@@ -1,11 +1,23 @@
 #ifndef MOMENTO_H
 #define MOMENTO_H
 
+#include <climits>
 #include <string>
 
 // Significa que não queremos comparar nossos valores.
 #define MOMENTO_DONT_COMPARE -1
 
+/*
+ * Momento completo compactado em um único inteiro: minutos desde 01/01/1970 00:00.
+ * A ordem dos instantes é a ordem cronológica, então comparar dois momentos
+ * completos custa uma única comparação de inteiros.
+ */
+typedef long long Instante;
+
+// Limites usados para intervalos abertos em uma das pontas.
+#define INSTANTE_MINIMO LLONG_MIN
+#define INSTANTE_MAXIMO LLONG_MAX
+
 // Estrutura de Data: 00/00/0000
 struct Data
 {
@@ -25,7 +37,7 @@ struct Data
         this->ano = ano;
     }
 
-    inline int Compare(const Data &other)
+    inline int Compare(const Data &other) const
     {
         // Caso na data que seja fornecido, tenha variáveis de valores igual a 0,
         // para esta lógica, estamos indicando que não queremos comparar esses parâmetros.
@@ -56,32 +68,32 @@ struct Data
         return 0;
     }
 
-    bool operator==(const Data &other)
+    bool operator==(const Data &other) const
     {
         return Compare(other) == 0;
     }
 
-    bool operator!=(const Data &other)
+    bool operator!=(const Data &other) const
     {
         return Compare(other) != 0;
     }
 
-    bool operator>(const Data &other)
+    bool operator>(const Data &other) const
     {
         return Compare(other) > 0;
     }
 
-    bool operator<(const Data &other)
+    bool operator<(const Data &other) const
     {
         return Compare(other) < 0;
     }
 
-    bool operator>=(const Data &other)
+    bool operator>=(const Data &other) const
     {
         return Compare(other) >= 0;
     }
 
-    bool operator<=(const Data &other)
+    bool operator<=(const Data &other) const
     {
         return Compare(other) <= 0;
     }
@@ -104,7 +116,7 @@ struct Horario
         this->minuto = minuto;
     }
 
-    inline int Compare(const Horario &other)
+    inline int Compare(const Horario &other) const
     {
         // Caso no horário que seja fornecido, tenha variáveis de valores igual a 0,
         // para esta lógica, estamos indicando que não queremos comparar esses parâmetros.
@@ -128,37 +140,87 @@ struct Horario
         return 0;
     }
 
-    bool operator==(const Horario &other)
+    bool operator==(const Horario &other) const
     {
         return Compare(other) == 0;
     }
 
-    bool operator!=(const Horario &other)
+    bool operator!=(const Horario &other) const
     {
         return Compare(other) != 0;
     }
 
-    bool operator>(const Horario &other)
+    bool operator>(const Horario &other) const
     {
         return Compare(other) > 0;
     }
 
-    bool operator<(const Horario &other)
+    bool operator<(const Horario &other) const
     {
         return Compare(other) < 0;
     }
 
-    bool operator>=(const Horario &other)
+    bool operator>=(const Horario &other) const
     {
         return Compare(other) >= 0;
     }
 
-    bool operator<=(const Horario &other)
+    bool operator<=(const Horario &other) const
     {
         return Compare(other) <= 0;
     }
 };
 
+/*
+ * @brief Quantidade de dias do mês informado, considerando anos bissextos.
+ * Retorna 0 para meses fora de 1 a 12.
+ */
+inline int DiasNoMes(int mes, int ano)
+{
+    static const int dias[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+    // Um mês que não existe não tem dias.
+    if (mes < 1 || mes > 12)
+        return 0;
+
+    if (mes == 2 && (ano % 4 == 0 && (ano % 100 != 0 || ano % 400 == 0)))
+        return 29;
+    return dias[mes - 1];
+}
+
+/*
+ * @brief Converte uma data do calendário em dias desde 01/01/1970.
+ */
+inline long long DiasDesdeEpoca(int dia, int mes, int ano)
+{
+    long long a = mes <= 2 ? ano - 1 : ano;
+    long long era = (a >= 0 ? a : a - 399) / 400;
+    long long ano_da_era = a - era * 400;
+    long long dia_do_ano = (153 * (mes > 2 ? mes - 3 : mes + 9) + 2) / 5 + dia - 1;
+    long long dia_da_era = ano_da_era * 365 + ano_da_era / 4 - ano_da_era / 100 + dia_do_ano;
+
+    return era * 146097 + dia_da_era - 719468;
+}
+
+/*
+ * @brief Converte dias desde 01/01/1970 de volta para uma data do calendário.
+ */
+inline Data DataDeDias(long long dias)
+{
+    dias += 719468;
+    long long era = (dias >= 0 ? dias : dias - 146096) / 146097;
+    long long dia_da_era = dias - era * 146097;
+    long long ano_da_era = (dia_da_era - dia_da_era / 1460 + dia_da_era / 36524 - dia_da_era / 146096) / 365;
+    long long dia_do_ano = dia_da_era - (365 * ano_da_era + ano_da_era / 4 - ano_da_era / 100);
+    long long mp = (5 * dia_do_ano + 2) / 153;
+
+    int dia = (int)(dia_do_ano - (153 * mp + 2) / 5 + 1);
+    int mes = (int)(mp < 10 ? mp + 3 : mp - 9);
+    int ano = (int)(ano_da_era + era * 400 + (mes <= 2 ? 1 : 0));
+
+    return Data(dia, mes, ano);
+}
+
 // Estrutura de momento, engloba data e horario juntos.
 // 00/00/0000 00:00
 struct Momento
@@ -185,7 +247,143 @@ struct Momento
         this->horario = Horario(hora, minuto);
     }
 
-    inline int Compare(const Momento &other)
+    /*
+     * @brief Diz se os campos informados formam um prefixo de (ano, mês, dia, hora, minuto).
+     * Só nesses casos a comparação parcial respeita a ordem cronológica, e o momento
+     * pode ser usado como limite de um intervalo ordenado.
+     */
+    inline bool IsOrdenavel() const
+    {
+        int campos[5] = {data.ano, data.mes, data.dia, horario.hora, horario.minuto};
+
+        bool ignorado = false;
+        for (int campo : campos)
+        {
+            if (campo == MOMENTO_DONT_COMPARE)
+                ignorado = true;
+            else if (ignorado)
+                return false;
+        }
+        return true;
+    }
+
+    /*
+     * @brief Diz se os campos informados existem no calendário: mês de 1 a 12, dia
+     * dentro do mês (sem o ano, 29 de fevereiro vale), hora de 0 a 23 e minuto de
+     * 0 a 59. As conversões para instantes e horas só valem para momentos válidos;
+     * um dia impossível cairia em outro dia.
+     */
+    inline bool IsValido() const
+    {
+        if (data.mes != MOMENTO_DONT_COMPARE && (data.mes < 1 || data.mes > 12))
+            return false;
+
+        if (data.dia != MOMENTO_DONT_COMPARE)
+        {
+            int maximo = data.mes == MOMENTO_DONT_COMPARE ? 31
+                                                          : DiasNoMes(data.mes, data.ano != MOMENTO_DONT_COMPARE ? data.ano : 2000);
+            if (data.dia < 1 || data.dia > maximo)
+                return false;
+        }
+
+        return (horario.hora == MOMENTO_DONT_COMPARE || (horario.hora >= 0 && horario.hora <= 23)) &&
+               (horario.minuto == MOMENTO_DONT_COMPARE || (horario.minuto >= 0 && horario.minuto <= 59));
+    }
+
+    /*
+     * @brief Diz se todos os campos do momento foram informados.
+     */
+    inline bool IsCompleto() const
+    {
+        return data.ano != MOMENTO_DONT_COMPARE && data.mes != MOMENTO_DONT_COMPARE &&
+               data.dia != MOMENTO_DONT_COMPARE && horario.hora != MOMENTO_DONT_COMPARE &&
+               horario.minuto != MOMENTO_DONT_COMPARE;
+    }
+
+    /*
+     * @brief Retorna o primeiro momento completo coberto por um momento ordenável,
+     * preenchendo os campos ignorados com o menor valor possível.
+     * O ano precisa ter sido informado.
+     */
+    inline Momento GetLimiteInferior() const
+    {
+        Momento m = *this;
+        if (m.data.mes == MOMENTO_DONT_COMPARE) m.data.mes = 1;
+        if (m.data.dia == MOMENTO_DONT_COMPARE) m.data.dia = 1;
+        if (m.horario.hora == MOMENTO_DONT_COMPARE) m.horario.hora = 0;
+        if (m.horario.minuto == MOMENTO_DONT_COMPARE) m.horario.minuto = 0;
+        return m;
+    }
+
+    /*
+     * @brief Retorna o último momento completo coberto por um momento ordenável,
+     * preenchendo os campos ignorados com o maior valor possível.
+     * O ano precisa ter sido informado.
+     */
+    inline Momento GetLimiteSuperior() const
+    {
+        Momento m = *this;
+        if (m.data.mes == MOMENTO_DONT_COMPARE) m.data.mes = 12;
+        if (m.data.dia == MOMENTO_DONT_COMPARE) m.data.dia = DiasNoMes(m.data.mes, m.data.ano);
+        if (m.horario.hora == MOMENTO_DONT_COMPARE) m.horario.hora = 23;
+        if (m.horario.minuto == MOMENTO_DONT_COMPARE) m.horario.minuto = 59;
+        return m;
+    }
+
+    /*
+     * @brief Converte um momento completo para o seu instante.
+     */
+    inline Instante GetInstante() const
+    {
+        return (DiasDesdeEpoca(data.dia, data.mes, data.ano) * 24 + horario.hora) * 60 + horario.minuto;
+    }
+
+    /*
+     * @brief Constrói o momento completo correspondente a um instante.
+     */
+    static inline Momento DeInstante(Instante instante)
+    {
+        long long dias = instante >= 0 ? instante / 1440 : (instante - 1439) / 1440;
+        int minutos = (int)(instante - dias * 1440);
+        return Momento(DataDeDias(dias), Horario(minutos / 60, minutos % 60));
+    }
+
+    /*
+     * @brief Primeiro instante coberto por um momento ordenável. Sem ano, o
+     * intervalo fica aberto e o resultado é INSTANTE_MINIMO.
+     */
+    inline Instante GetInstanteInferior() const
+    {
+        return data.ano == MOMENTO_DONT_COMPARE ? INSTANTE_MINIMO : GetLimiteInferior().GetInstante();
+    }
+
+    /*
+     * @brief Último instante coberto por um momento ordenável. Sem ano, o
+     * intervalo fica aberto e o resultado é INSTANTE_MAXIMO.
+     */
+    inline Instante GetInstanteSuperior() const
+    {
+        return data.ano == MOMENTO_DONT_COMPARE ? INSTANTE_MAXIMO : GetLimiteSuperior().GetInstante();
+    }
+
+    /*
+     * @brief Quantidade de horas inteiras desde 01/01/1970 00:00, ignorando os minutos.
+     */
+    inline long long GetHoras() const
+    {
+        return DiasDesdeEpoca(data.dia, data.mes, data.ano) * 24 + horario.hora;
+    }
+
+    /*
+     * @brief Constrói o momento correspondente a uma quantidade de horas desde 01/01/1970.
+     */
+    static inline Momento DeHoras(long long horas)
+    {
+        long long dias = horas >= 0 ? horas / 24 : (horas - 23) / 24;
+        return Momento(DataDeDias(dias), Horario((int)(horas - dias * 24), 0));
+    }
+
+    inline int Compare(const Momento &other) const
     {
         int v = this->data.Compare(other.data);
         if (v != 0)
@@ -197,32 +395,32 @@ struct Momento
         return 0;
     }
 
-    bool operator==(const Momento &other)
+    bool operator==(const Momento &other) const
     {
         return Compare(other) == 0;
     }
 
-    bool operator!=(const Momento &other)
+    bool operator!=(const Momento &other) const
     {
         return Compare(other) != 0;
     }
 
-    bool operator>(const Momento &other)
+    bool operator>(const Momento &other) const
     {
         return Compare(other) > 0;
     }
 
-    bool operator<(const Momento &other)
+    bool operator<(const Momento &other) const
     {
         return Compare(other) < 0;
     }
 
-    bool operator>=(const Momento &other)
+    bool operator>=(const Momento &other) const
     {
         return Compare(other) >= 0;
     }
 
-    bool operator<=(const Momento &other)
+    bool operator<=(const Momento &other) const
     {
         return Compare(other) <= 0;
     }
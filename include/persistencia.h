@@ -0,0 +1,98 @@
+#ifndef PERSISTENCIA_H
+#define PERSISTENCIA_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <mapeamento.h>
+
+// Extensão do arquivo de índice, gravado ao lado do CSV.
+#define PERSISTENCIA_EXTENSAO ".idx"
+#define PERSISTENCIA_VERSAO 2
+
+// Tamanho das janelas do início e do fim do CSV usadas na soma de verificação.
+#define PERSISTENCIA_JANELA (64 * 1024)
+
+/*
+ * Identificação do conteúdo de um CSV: se qualquer campo mudar, o índice
+ * persistido deixa de valer.
+ *
+ * A soma cobre só as janelas do início e do fim, para que conferir o índice não
+ * custe uma leitura do arquivo inteiro; uma edição no meio que preserve o
+ * tamanho não muda a soma. Quem a detecta são os metadados: o inode muda quando
+ * o arquivo é substituído, e a mudança de estado (st_ctime) a cada escrita, sem
+ * que ferramentas como touch possam restaurá-la como fazem com st_mtime.
+ */
+typedef struct AssinaturaArquivo
+{
+    uint64_t tamanho;
+    int64_t modificacao; // st_mtime, em nanossegundos.
+    int64_t mudanca;     // st_ctime, em nanossegundos.
+    uint64_t inode;
+    uint64_t soma;       // FNV-1a das janelas do início e do fim do arquivo.
+} AssinaturaArquivo;
+
+/*
+ * Linha indexada como gravada no arquivo de índice.
+ */
+typedef struct RegistroIndice
+{
+    int32_t ano;
+    int8_t mes, dia, hora, minuto;
+    uint64_t posicao;
+} RegistroIndice;
+
+typedef std::vector<std::pair<std::string, std::string>> CabecalhoPersistido;
+
+/*
+ * @brief Calcula a assinatura atual de um CSV.
+ * @return false se o arquivo não pôde ser lido.
+ */
+bool GetAssinatura(const char *caminho, AssinaturaArquivo *assinatura);
+
+/*
+ * @brief Grava o arquivo de índice. A gravação é feita em um arquivo temporário
+ * renomeado no fim, então um índice pela metade nunca é visto.
+ * @return false se o arquivo não pôde ser gravado.
+ */
+bool SalvarIndice(const char *caminho, const AssinaturaArquivo &assinatura,
+                  const CabecalhoPersistido &cabecalho, const std::vector<RegistroIndice> &registros);
+
+/*
+ * Leitura de um arquivo de índice, mapeado em memória.
+ */
+class LeitorIndice
+{
+private:
+    Mapeamento mapa;
+    CabecalhoPersistido cabecalho;
+
+    const RegistroIndice *registros = nullptr;
+    uint64_t quantidade = 0;
+
+public:
+    /*
+     * @brief Abre o arquivo de índice e confere se ele pertence ao CSV com a assinatura informada.
+     * @return false se o índice não existe, está corrompido ou é de outra versão do CSV.
+     */
+    bool Abrir(const char *caminho, const AssinaturaArquivo &assinatura);
+
+    inline const CabecalhoPersistido &GetCabecalho() const
+    {
+        return this->cabecalho;
+    }
+
+    inline const RegistroIndice *GetRegistros() const
+    {
+        return this->registros;
+    }
+
+    inline uint64_t GetQuantidade() const
+    {
+        return this->quantidade;
+    }
+};
+
+#endif // !PERSISTENCIA_H
@@ -0,0 +1,98 @@
+#ifndef PIRAMIDE_H
+#define PIRAMIDE_H
+
+#include <vector>
+
+#include <agregacao.h>
+#include <colunas.h>
+#include <momento.h>
+
+// Níveis da pirâmide, do mais fino ao mais grosso.
+#define PIRAMIDE_DIA 0
+#define PIRAMIDE_MES 1
+#define PIRAMIDE_ANO 2
+#define PIRAMIDE_NIVEIS 3
+
+/*
+ * Resumo de todas as variáveis das linhas de um dia, mês ou ano.
+ * A chave é o número de dias desde 01/01/1970, o número de meses desde
+ * o ano 0 (ano * 12 + mês - 1) ou o próprio ano, conforme o nível.
+ */
+typedef struct Balde
+{
+    long long chave;
+    Agregado agregados[QUANTIDADE_VARIAVEIS];
+} Balde;
+
+/*
+ * Pirâmide de resumos pré-calculados de uma série: por dia, por mês e por ano.
+ * Um intervalo de dias completos é resumido combinando poucos baldes grossos
+ * com os baldes finos das pontas, então o custo quase não depende do tamanho
+ * do intervalo.
+ */
+class Piramide
+{
+private:
+    // Baldes de cada nível, em ordem crescente de chave. Só existem baldes com linhas.
+    std::vector<Balde> niveis[PIRAMIDE_NIVEIS];
+
+    static long long chave(const Momento &momento, int nivel);
+
+    /*
+     * @brief Combina os baldes de um nível com chave entre 'de' e 'ate' (inclusive).
+     * @return true se algum balde foi combinado.
+     */
+    bool somar(int nivel, long long de, long long ate, unsigned variaveis, Agregado *agregados) const;
+
+public:
+    Piramide() = default;
+
+    /*
+     * @brief Acrescenta uma linha à pirâmide. As linhas precisam ser adicionadas
+     * em ordem cronológica, e o momento precisa estar completo.
+     * @param valores: as variáveis da linha, na ordem dos arquivos do INMET.
+     */
+    void Adicionar(const Momento &momento, const double *valores);
+
+    /*
+     * @brief Remove o último dia e refaz os baldes do mês e do ano dele com os
+     * dias que sobraram. Um resumo não desfaz um valor, então trocar a última
+     * linha é remover o dia dela e adicionar de novo as linhas dele.
+     */
+    void RemoverUltimoDia();
+
+    /*
+     * @brief Remove todos os baldes.
+     */
+    void Limpar();
+
+    /*
+     * @brief Resume as variáveis escolhidas de todas as linhas entre dois dias
+     * (em dias desde 01/01/1970, inclusive).
+     * @return true se alguma linha foi encontrada.
+     */
+    bool Agregar(long long primeiro_dia, long long ultimo_dia, unsigned variaveis, Agregado *agregados) const;
+
+    /*
+     * @brief Primeiro dia com linhas, em dias desde 01/01/1970.
+     */
+    inline long long GetPrimeiroDia() const
+    {
+        return this->niveis[PIRAMIDE_DIA].front().chave;
+    }
+
+    /*
+     * @brief Último dia com linhas, em dias desde 01/01/1970.
+     */
+    inline long long GetUltimoDia() const
+    {
+        return this->niveis[PIRAMIDE_DIA].back().chave;
+    }
+
+    inline bool IsVazia() const
+    {
+        return this->niveis[PIRAMIDE_DIA].empty();
+    }
+};
+
+#endif // !PIRAMIDE_H
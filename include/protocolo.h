@@ -0,0 +1,90 @@
+#ifndef PROTOCOLO_H
+#define PROTOCOLO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*
+ * Protocolo entre o servidor de consultas e os clientes, sobre um socket Unix.
+ *
+ * Cada pedido é um cabeçalho fixo seguido do texto de uma consulta, na mesma
+ * sintaxe do modo --batch ("resumo 2024-03 2024-04"). Cada resposta é um
+ * cabeçalho fixo seguido dos registros que ExecutarConsulta escreve, em CSV
+ * ou JSON. As respostas saem na ordem dos pedidos da mesma conexão, então um
+ * cliente pode enviar vários pedidos antes de ler as respostas.
+ *
+ * Os inteiros vão na ordem de bytes da máquina: cliente e servidor estão
+ * sempre no mesmo computador.
+ */
+
+// Versão do protocolo, conferida em cada pedido.
+#define PROTOCOLO_VERSAO 1
+
+// Maior consulta aceita em um pedido; pedidos maiores encerram a conexão.
+#define PROTOCOLO_TAMANHO_CONSULTA 4096
+
+// Maior resposta enviada. Uma consulta que passaria disso recebe só um registro de
+// erro, com PROTOCOLO_ERRO_RESPOSTA, e pode ser repetida em intervalos menores.
+#define PROTOCOLO_TAMANHO_RESPOSTA (128 * 1024 * 1024)
+
+// Estados das respostas.
+#define PROTOCOLO_OK 0
+#define PROTOCOLO_ERRO_CONSULTA 1 // a consulta é inválida; a resposta traz o registro de erro
+#define PROTOCOLO_ERRO_PEDIDO 2   // estação, formato ou versão desconhecidos; idem
+#define PROTOCOLO_ERRO_RESPOSTA 3 // a resposta passaria de PROTOCOLO_TAMANHO_RESPOSTA; idem
+
+/*
+ * Cabeçalho de um pedido.
+ */
+typedef struct CabecalhoPedido
+{
+    uint32_t tamanho; // bytes da consulta, logo após o cabeçalho
+    uint32_t numero;  // número da consulta, repetido na resposta e nos registros
+    uint16_t estacao; // posição do arquivo na linha de comando do servidor
+    uint8_t formato;  // FORMATO_CSV ou FORMATO_JSON
+    uint8_t versao;   // PROTOCOLO_VERSAO
+} CabecalhoPedido;
+
+/*
+ * Cabeçalho de uma resposta.
+ */
+typedef struct CabecalhoResposta
+{
+    uint32_t tamanho; // bytes dos registros, logo após o cabeçalho
+    uint32_t numero;  // número do pedido respondido
+    uint8_t estado;   // PROTOCOLO_*
+    uint8_t reservado[3];
+} CabecalhoResposta;
+
+/*
+ * @brief Conecta ao servidor que escuta no socket Unix informado.
+ * @return O descritor da conexão, ou -1 se não foi possível conectar.
+ */
+int ConectarServidor(const char *caminho);
+
+/*
+ * @brief Envia um pedido com uma consulta.
+ * @return false se a conexão foi perdida.
+ */
+bool EnviarPedido(int conexao, uint32_t numero, uint16_t estacao, uint8_t formato, const char *consulta, size_t tamanho);
+
+/*
+ * @brief Recebe o próximo pedido da conexão.
+ * @return false se a conexão terminou, ou o pedido é maior que PROTOCOLO_TAMANHO_CONSULTA.
+ */
+bool ReceberPedido(int conexao, CabecalhoPedido *cabecalho, std::string &consulta);
+
+/*
+ * @brief Envia a resposta de um pedido.
+ * @return false se a conexão foi perdida, ou a resposta é maior que PROTOCOLO_TAMANHO_RESPOSTA.
+ */
+bool EnviarResposta(int conexao, uint32_t numero, uint8_t estado, const char *dados, size_t tamanho);
+
+/*
+ * @brief Recebe a próxima resposta da conexão.
+ * @return false se a conexão terminou, ou a resposta é maior que PROTOCOLO_TAMANHO_RESPOSTA.
+ */
+bool ReceberResposta(int conexao, CabecalhoResposta *cabecalho, std::string &dados);
+
+#endif // !PROTOCOLO_H
@@ -0,0 +1,86 @@
+#ifndef RASTREIO_H
+#define RASTREIO_H
+
+#include <chrono>
+#include <cstdint>
+
+/*
+ * Trechos de execução (carga, indexação, consultas, leitura de linhas) exportados
+ * no formato de eventos de trace do Chrome, que o Perfetto e o chrome://tracing abrem.
+ *
+ * Cada thread grava os seus trechos em um buffer circular próprio, sem travas:
+ * quando ele enche, os trechos mais antigos dão lugar aos novos. Um trecho é
+ * gravado ao terminar, então os trechos externos (uma consulta inteira)
+ * sobrevivem aos muitos trechos curtos (as linhas) que aconteceram dentro deles.
+ *
+ * Os buffers crescem conforme os trechos chegam, até RASTREIO_CAPACIDADE. Quando
+ * uma thread termina, o buffer dela passa para a próxima thread que rastrear,
+ * na mesma linha do tempo: a memória acompanha o máximo de threads ao mesmo tempo,
+ * e não o total de threads criadas.
+ *
+ * Com SERIES_RASTREIO desligada na compilação, RASTREAR não gera código algum;
+ * ligada, custa só um teste enquanto o rastreio não é ativado.
+ */
+
+// Trechos guardados por thread antes de começar a sobrescrever os mais antigos.
+#define RASTREIO_CAPACIDADE (1 << 18)
+
+// Ativado antes de qualquer trecho, e não muda mais depois disso.
+inline bool rastreio_ativo = false;
+
+/*
+ * @brief Ativa a gravação dos trechos. Deve ser chamada antes de criar threads.
+ */
+void RastreioAtivar();
+
+/*
+ * @brief Nanossegundos desde a ativação do rastreio.
+ */
+uint64_t RastreioAgora();
+
+/*
+ * @brief Grava um trecho já terminado na thread atual.
+ * @param nome: texto estático, que precisa existir até o rastreio ser salvo.
+ */
+void RastreioGravar(const char *nome, uint64_t inicio, uint64_t fim);
+
+/*
+ * @brief Escreve os trechos de todas as threads em JSON de eventos de trace.
+ * As threads que gravaram trechos precisam ter terminado ou estar paradas.
+ * @return false se o arquivo não pôde ser escrito.
+ */
+bool RastreioSalvar(const char *caminho);
+
+/*
+ * Grava o tempo de vida do escopo em que foi declarado como um trecho.
+ */
+class TrechoRastreio
+{
+private:
+    const char *nome;
+    uint64_t inicio = 0;
+
+public:
+    explicit TrechoRastreio(const char *nome) : nome(rastreio_ativo ? nome : nullptr)
+    {
+        if (this->nome != nullptr)
+            inicio = RastreioAgora();
+    }
+
+    ~TrechoRastreio()
+    {
+        if (nome != nullptr)
+            RastreioGravar(nome, inicio, RastreioAgora());
+    }
+
+    TrechoRastreio(const TrechoRastreio &) = delete;
+    TrechoRastreio &operator=(const TrechoRastreio &) = delete;
+};
+
+#ifdef SERIES_RASTREIO
+#define RASTREAR(nome) TrechoRastreio trecho_rastreio(nome)
+#else
+#define RASTREAR(nome) ((void)0)
+#endif
+
+#endif // !RASTREIO_H
@@ -0,0 +1,152 @@
+#ifndef SAIDA_H
+#define SAIDA_H
+
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+// Tamanho do buffer de saída antes de cada escrita no descritor.
+#define SAIDA_TAMANHO_BUFFER (64 * 1024)
+
+// Maior quantidade de caracteres de um número formatado.
+#define SAIDA_TAMANHO_NUMERO 32
+
+/*
+ * Escritor com buffer para saídas grandes. Os números são formatados com
+ * std::to_chars direto no buffer, sem alocações e sem depender do locale.
+ * Com um descritor, o buffer é escrito nele sempre que enche; sem descritor
+ * (-1), o conteúdo só acumula e fica disponível em GetDados(), até um limite
+ * opcional.
+ */
+class Saida
+{
+private:
+    int descritor;
+    std::vector<char> buffer;
+    size_t usado = 0;
+
+    // Alguma escrita no descritor já falhou; o conteúdo dela foi perdido.
+    bool falhou = false;
+
+    // Sem descritor, o maior conteúdo acumulado (0: sem limite), e se ele já foi passado.
+    size_t limite;
+    bool excedido = false;
+
+    /*
+     * @brief Garante espaço livre no buffer para mais 'tamanho' bytes.
+     */
+    inline char *reservar(size_t tamanho)
+    {
+        if (usado + tamanho > buffer.size())
+            crescer(tamanho);
+        return buffer.data() + usado;
+    }
+
+    void crescer(size_t tamanho);
+
+public:
+    /*
+     * @param descritor: descritor onde o buffer é escrito, ou -1 para só acumular.
+     * @param limite: sem descritor, quantos bytes podem acumular (0: sem limite).
+     * Passado o limite, o conteúdo é descartado e IsExcedida() diz true; as
+     * escritas seguintes não ocupam mais memória.
+     */
+    explicit Saida(int descritor = -1, size_t limite = 0);
+    ~Saida();
+
+    Saida(const Saida &) = delete;
+    Saida &operator=(const Saida &) = delete;
+
+    inline void Escrever(const char *texto, size_t tamanho)
+    {
+        memcpy(reservar(tamanho), texto, tamanho);
+        usado += tamanho;
+    }
+
+    inline void Escrever(const char *texto)
+    {
+        Escrever(texto, strlen(texto));
+    }
+
+    inline void Escrever(char caractere)
+    {
+        *reservar(1) = caractere;
+        usado++;
+    }
+
+    /*
+     * @brief Escreve 'quantidade' cópias de um caractere, como no preenchimento de colunas.
+     */
+    inline void EscreverRepetido(char caractere, size_t quantidade)
+    {
+        memset(reservar(quantidade), caractere, quantidade);
+        usado += quantidade;
+    }
+
+    inline void EscreverInteiro(long long valor)
+    {
+        char *p = reservar(SAIDA_TAMANHO_NUMERO);
+        usado = std::to_chars(p, p + SAIDA_TAMANHO_NUMERO, valor).ptr - buffer.data();
+    }
+
+    /*
+     * @brief Escreve um double na menor forma que o lê de volta sem perdas.
+     */
+    inline void EscreverDecimal(double valor)
+    {
+        char *p = reservar(SAIDA_TAMANHO_NUMERO);
+        usado = std::to_chars(p, p + SAIDA_TAMANHO_NUMERO, valor).ptr - buffer.data();
+    }
+
+    /*
+     * @brief Escreve um double com uma quantidade fixa de casas decimais.
+     */
+    inline void EscreverDecimal(double valor, int casas)
+    {
+        char *p = reservar(SAIDA_TAMANHO_NUMERO);
+        auto resultado = std::to_chars(p, p + SAIDA_TAMANHO_NUMERO, valor, std::chars_format::fixed, casas);
+
+        // Números grandes demais para a forma fixa saem na forma mais curta.
+        if (resultado.ec != std::errc())
+            resultado = std::to_chars(p, p + SAIDA_TAMANHO_NUMERO, valor);
+        usado = resultado.ptr - buffer.data();
+    }
+
+    /*
+     * @brief Escreve no descritor tudo o que está no buffer.
+     * @return false se esta ou alguma escrita anterior falhou, inclusive as
+     * feitas sozinhas quando o buffer encheu.
+     */
+    bool Descarregar();
+
+    /*
+     * @brief Descarta o conteúdo acumulado, sem escrevê-lo, e volta a aceitar
+     * escritas até o limite.
+     */
+    inline void Limpar()
+    {
+        usado = 0;
+        excedido = false;
+    }
+
+    /*
+     * @brief Diz se o conteúdo acumulado passou do limite e foi descartado.
+     */
+    inline bool IsExcedida() const
+    {
+        return excedido;
+    }
+
+    inline const char *GetDados() const
+    {
+        return buffer.data();
+    }
+
+    inline size_t GetTamanho() const
+    {
+        return usado;
+    }
+};
+
+#endif // !SAIDA_H
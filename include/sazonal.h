@@ -0,0 +1,58 @@
+#ifndef SAZONAL_H
+#define SAZONAL_H
+
+#include <vector>
+
+#include <momento.h>
+
+#define SAZONAL_MESES 12
+#define SAZONAL_HORAS 24
+
+/*
+ * Índice secundário para consultas sazonais, como "todo julho às 15:00".
+ * Guarda, para cada combinação de mês do ano e hora do dia, os instantes das
+ * linhas daquela combinação em ordem cronológica. Uma consulta com campos
+ * ignorados fora de ordem visita só as combinações que podem satisfazê-la,
+ * em vez de percorrer a série inteira.
+ */
+class IndiceSazonal
+{
+private:
+    std::vector<Instante> celulas[SAZONAL_MESES][SAZONAL_HORAS];
+    long long quantidade = 0;
+
+public:
+    IndiceSazonal() = default;
+
+    /*
+     * @brief Indexa o instante de uma linha. Os instantes precisam ser
+     * inseridos em ordem cronológica.
+     */
+    void Inserir(Instante instante);
+
+    /*
+     * @brief Remove todos os instantes.
+     */
+    void Limpar();
+
+    /*
+     * @brief Junta, em ordem cronológica, os instantes das combinações de mês e
+     * hora que podem ter momentos entre 'de' e 'ate'. Os instantes ainda precisam
+     * ser conferidos com a comparação exata, pois dia, minuto e ano não são filtrados.
+     * @return false se todas as combinações podem ter momentos no intervalo; nesse
+     * caso o índice não ajuda e 'instantes' fica intocado.
+     */
+    bool GetCandidatos(const Momento &de, const Momento &ate, std::vector<Instante> &instantes) const;
+
+    inline long long GetQuantidade() const
+    {
+        return this->quantidade;
+    }
+
+    inline bool IsVazio() const
+    {
+        return this->quantidade == 0;
+    }
+};
+
+#endif // !SAZONAL_H
@@ -1,14 +1,55 @@
 #ifndef ARQUIVO_H
 #define ARQUIVO_H
 
+#include <atomic>
 #include <fstream>
+#include <functional>
+#include <limits>
 #include <sstream>
+#include <vector>
 
+#include <agregacao.h>
 #include <arvore.h>
+#include <colunas.h>
+#include <indice.h>
 #include <lista.h>
+#include <mapeamento.h>
+#include <persistencia.h>
+#include <piramide.h>
+#include <sazonal.h>
 
 #include <momento.h>
 
+// Opções de carregamento da série, combináveis com '|'.
+#define SERIES_PADRAO 0
+// Usa o índice horário compacto no lugar da árvore, quando o arquivo permitir.
+#define SERIES_INDICE_COMPACTO 1
+// Mapeia o arquivo em memória e lê as linhas direto dele, sem uma leitura por linha.
+// Se o arquivo encolher, as consultas seguintes voltam a ler pela posição.
+#define SERIES_MAPEAR 2
+// Divide o arquivo em pedaços e indexa cada um em uma thread.
+#define SERIES_PARALELO 4
+// Salva o índice ao lado do CSV (arquivo.csv.idx) e o reaproveita enquanto o CSV não mudar.
+#define SERIES_INDICE_PERSISTENTE 8
+// Decodifica o arquivo inteiro uma única vez e guarda as variáveis em colunas.
+#define SERIES_CARREGAR_TUDO 16
+// Pré-calcula resumos por dia, mês e ano para agregar intervalos longos rapidamente.
+#define SERIES_PIRAMIDE 32
+// Indexa as linhas também por mês do ano e hora do dia, para consultas com campos ignorados.
+#define SERIES_INDICE_SAZONAL 64
+
+// Tamanho dos blocos lidos do arquivo durante a indexação.
+#define SERIES_TAMANHO_BLOCO (1 << 20)
+
+// Bytes lidos de uma vez para cada linha sem mapeamento; linhas maiores pedem mais leituras.
+#define SERIES_TAMANHO_LINHA 512
+
+// Quantidade de linhas reunidas em colunas antes de cada passo de agregação.
+#define SERIES_BLOCO_AGREGACAO 256
+
+// Valor das variáveis ausentes no arquivo (campo vazio ou -9999).
+#define VALOR_AUSENTE (std::numeric_limits<double>::quiet_NaN())
+
 /*
  * Coordenada de uma posição dos dados em bytes do arquivo.
  */
@@ -46,16 +87,125 @@ typedef struct Linha
 
 } Linha;
 
+/*
+ * @brief Diz se o valor de uma variável está ausente.
+ */
+inline bool IsAusente(double valor)
+{
+    return valor != valor;
+}
+
+/*
+ * Variáveis de uma linha, na ordem em que aparecem nos arquivos do INMET.
+ */
+inline constexpr double Linha::*VARIAVEIS_LINHA[QUANTIDADE_VARIAVEIS] = {
+    &Linha::precipitacao_total, &Linha::pressao_atmosferica, &Linha::pressao_atmosferica_max,
+    &Linha::pressao_atmosferica_min, &Linha::radiacao_global, &Linha::temperatura_ar,
+    &Linha::temperatura_orvalho, &Linha::temperatura_ar_max, &Linha::temperatura_ar_min,
+    &Linha::temperatura_orvalho_max, &Linha::temperatura_orvalho_min, &Linha::umidade_relativa_max,
+    &Linha::umidade_relativa_min, &Linha::umidade_relativa, &Linha::vento_direcao,
+    &Linha::vento_rajada, &Linha::vento_velocidade};
+
+/*
+ * Nome de cada variável, na mesma ordem de VARIAVEIS_LINHA.
+ */
+inline constexpr const char *NOMES_VARIAVEIS[QUANTIDADE_VARIAVEIS] = {
+    "precipitacao_total", "pressao_atmosferica", "pressao_atmosferica_max",
+    "pressao_atmosferica_min", "radiacao_global", "temperatura_ar",
+    "temperatura_orvalho", "temperatura_ar_max", "temperatura_ar_min",
+    "temperatura_orvalho_max", "temperatura_orvalho_min", "umidade_relativa_max",
+    "umidade_relativa_min", "umidade_relativa", "vento_direcao",
+    "vento_rajada", "vento_velocidade"};
+
+/*
+ * Função chamada para cada linha visitada por Series::ParaCada. A linha só é
+ * válida durante a chamada. Retornar false interrompe a visita.
+ */
+typedef std::function<bool(const Linha &)> VisitanteLinha;
+
+/*
+ * Resumo de linhas entregues uma a uma, como as de um visitante de ParaCada.
+ * As linhas são reunidas em blocos por coluna, para usar o mesmo kernel das
+ * colunas carregadas.
+ */
+class AgregadorLinhas
+{
+private:
+    unsigned variaveis;
+    Agregado *agregados;
+
+    double bloco[QUANTIDADE_VARIAVEIS][SERIES_BLOCO_AGREGACAO];
+    int quantidade = 0;
+
+public:
+    /*
+     * @param variaveis: máscara de bits (1u << VARIAVEL_*) das variáveis resumidas.
+     * @param agregados: vetor com QUANTIDADE_VARIAVEIS posições, que recebe os resumos.
+     */
+    AgregadorLinhas(unsigned variaveis, Agregado *agregados) : variaveis(variaveis), agregados(agregados) {}
+
+    inline void Adicionar(const Linha &linha)
+    {
+        for (int v = 0; v < QUANTIDADE_VARIAVEIS; v++)
+            bloco[v][quantidade] = linha.*VARIAVEIS_LINHA[v];
+
+        if (++quantidade == SERIES_BLOCO_AGREGACAO)
+            Concluir();
+    }
+
+    /*
+     * @brief Acumula nos resumos as linhas ainda no bloco. Precisa ser chamada
+     * depois da última linha.
+     */
+    void Concluir();
+};
+
+/*
+ * Momento de uma linha e a coordenada dos seus valores, encontrados na indexação.
+ */
+typedef struct EntradaIndice
+{
+    Momento momento;
+    Coordenada coordenada;
+} EntradaIndice;
+
 /*
  * Classe dedicada para a leitura e tratamento dos dados de um arquivo.
+ *
+ * Depois de construída, a série pode ser consultada (GetLinha, GetLinhas,
+ * ParaCada e Agregar) por várias threads ao mesmo tempo, sem travas: as
+ * consultas só leem o índice, e leem o arquivo pela posição (pread) ou pelo
+ * mapeamento. Atualizar altera o índice e não pode rodar junto com consultas.
  */
 class Series
 {
 private:
-    std::ifstream fluxo;
+    // Descritor do arquivo, lido sempre pela posição: não há posição de leitura compartilhada.
+    int descritor;
+    std::string caminho;
+    Mapeamento mapa;
+
+    std::vector<EntradaIndice> entradas;
 
     Arvore<std::string, std::string> cabecalho;
-    Arvore<Momento, Coordenada> dados;
+    Arvore<Instante, Coordenada> dados;
+    IndiceHorario horario;
+    Colunas colunas;
+    Piramide piramide;
+    IndiceSazonal sazonal;
+
+    int opcoes;
+    bool compacto;
+    bool colunar;
+
+    // Fim da última linha completa indexada, de onde Atualizar continua.
+    uint64_t indexado;
+    // Bytes do arquivo já varridos. Passa de 'indexado' quando a última linha do
+    // arquivo, sem quebra de linha, foi indexada mesmo assim na carga.
+    uint64_t varrido;
+
+    // O arquivo mapeado encolheu: as linhas passam a ser lidas pela posição.
+    std::atomic<bool> encolhido{false};
 
     /*
      * @brief Inicializa todo o sistema com a interpretação dos cabeçalhos de dados
@@ -63,25 +213,179 @@ private:
      */
     void Inicializar();
 
+    /*
+     * @brief Lê e indexa todas as linhas do arquivo.
+     */
+    void IndexarArquivo();
+
+    /*
+     * @brief Carrega o cabeçalho e o índice de um arquivo de índice salvo anteriormente.
+     * @return false se não há índice salvo válido para o conteúdo atual do arquivo.
+     */
+    bool CarregarIndicePersistente(const AssinaturaArquivo &assinatura);
+
+    /*
+     * @brief Salva o cabeçalho e o índice atuais ao lado do arquivo.
+     */
+    void SalvarIndicePersistente(const AssinaturaArquivo &assinatura);
+
+    /*
+     * @brief Interpreta as linhas de cabeçalho e a linha de títulos no início do arquivo.
+     * @return Quantidade de bytes consumidos.
+     */
+    size_t LerCabecalho(const char *inicio, const char *fim);
+
+    /*
+     * @brief Encontra o momento e a coordenada de todas as linhas completas de um bloco
+     * do arquivo, sem alterar a série. Pode ser chamada em várias threads.
+     * @param deslocamento: posição do início do bloco no arquivo.
+     * @param final: se o bloco vai até o fim do arquivo, a última linha
+     * é considerada mesmo sem a quebra de linha.
+     * @param entradas: vetor onde as linhas encontradas são adicionadas.
+     * @return Quantidade de bytes consumidos (até a última linha completa).
+     */
+    static size_t AnalisarBloco(const char *inicio, const char *fim, uint64_t deslocamento, bool final,
+                                std::vector<EntradaIndice> &entradas);
+
+    /*
+     * @brief Indexa todas as linhas completas de um bloco do arquivo.
+     * @return Quantidade de bytes consumidos (até a última linha completa).
+     */
+    size_t IndexarBloco(const char *inicio, const char *fim, uint64_t deslocamento, bool final);
+
+    /*
+     * @brief Indexa o corpo do arquivo, já em memória, dividindo-o entre várias threads.
+     */
+    void IndexarParalelo(const char *inicio, const char *fim, uint64_t deslocamento);
+
+    /*
+     * @brief Diz se as linhas podem ser lidas do mapeamento. Confere, uma vez por
+     * consulta, se o arquivo ainda cobre o mapeamento: se ele foi truncado, ler as
+     * páginas que sobraram geraria SIGBUS, e a série passa a ler pela posição.
+     * Um arquivo truncado no meio de uma consulta ainda derruba o programa; com
+     * --mapear, o arquivo só deve crescer.
+     */
+    bool ConferirMapa();
+
     /*
      * @brief Lê uma linha indexada por uma coordenada, e salva dentro do parâmetro
-     * do tipo Linha*.
+     * do tipo Linha*. Pode ser chamada em várias threads.
      * @param coordenada: coordenada da indexação do árquivo.
      * @param linha: linha a ser atulizada com os valores lido do arquivo.
      */
     bool LerLinha(Coordenada coordenada, Linha *linha);
 
+    /*
+     * @brief Interpreta os valores de uma linha já em memória, a partir da coordenada
+     * indexada. A leitura para na primeira quebra de linha ou em 'fim'.
+     */
+    bool LerLinha(const char *inicio, const char *fim, Linha *linha);
+
+    /*
+     * @brief Indexa a coordenada de um momento no índice em uso. Se o índice
+     * compacto não aceitar o momento, todo o índice é migrado para a árvore.
+     */
+    void Indexar(Momento &momento, Coordenada coordenada);
+
+    /*
+     * @brief Implementação de ParaCada sobre o índice horário compacto.
+     */
+    bool ParaCadaCompacto(Momento &de, Momento &ate, VisitanteLinha &visitante);
+
+    /*
+     * @brief Implementação de ParaCada sobre as colunas carregadas.
+     */
+    bool ParaCadaColunas(Momento &de, Momento &ate, VisitanteLinha &visitante);
+
+    /*
+     * @brief Lista, em ordem cronológica, todos os momentos indexados e suas coordenadas.
+     */
+    void ListarIndice(std::vector<EntradaIndice> &entradas);
+
+    /*
+     * @brief Decodifica as linhas das entradas, em ordem, e entrega o momento e as
+     * variáveis (na ordem do INMET) de cada uma ao visitante.
+     * Linhas que não puderam ser decodificadas são puladas.
+     */
+    void DecodificarLinhas(const std::vector<EntradaIndice> &entradas,
+                           const std::function<void(const Momento &, const double *)> &visitante);
+
+    /*
+     * @brief Decodifica todas as linhas indexadas para as colunas.
+     */
+    void CarregarColunas();
+
+    /*
+     * @brief Calcula os resumos por dia, mês e ano de todas as linhas indexadas.
+     */
+    void CarregarPiramide();
+
+    /*
+     * @brief Indexa o instante de todas as linhas no índice sazonal.
+     */
+    void CarregarSazonal();
+
+    /*
+     * @brief Instante da última linha em ordem cronológica no índice em uso.
+     * @return false se nada foi indexado.
+     */
+    bool GetUltimoInstante(Instante *instante);
+
+    /*
+     * @brief Indexa as linhas novas encontradas por Atualizar e leva as
+     * colunas, a pirâmide e o índice sazonal junto. Linhas que chegam depois
+     * de todas as indexadas são apenas acrescentadas; qualquer outra obriga a
+     * recalcular essas estruturas por inteiro.
+     */
+    void IndexarNovas(const std::vector<EntradaIndice> &novas);
+
+    /*
+     * @brief Troca, nas colunas e na pirâmide, os valores da última linha, que a
+     * carga indexou ainda sem a quebra de linha e Atualizar encontrou completa.
+     * O índice e o índice sazonal guardam só o instante e a posição, que não mudam.
+     */
+    void SubstituirUltima(const EntradaIndice &entrada);
+
+    /*
+     * @brief Lê a linha de um instante exato, pelo índice em uso.
+     */
+    bool LerInstante(Instante instante, Linha *linha);
+
+    /*
+     * @brief Implementação de ParaCada sobre o índice sazonal, para limites com
+     * campos ignorados fora de ordem.
+     * @param usado: recebe false se o índice não ajuda nesse intervalo e nada foi visitado.
+     */
+    bool ParaCadaSazonal(Momento &de, Momento &ate, VisitanteLinha &visitante, bool *usado);
+
+    /*
+     * @brief Implementação de Agregar que visita cada linha do intervalo.
+     */
+    bool AgregarLinhas(Momento &de, Momento &ate, unsigned variaveis, Agregado *agregados);
+
+    /*
+     * @brief Copia uma linha das colunas para o parâmetro linha.
+     */
+    void LerColunas(long long indice, Linha *linha);
+
 public:
     /*
      * @brief Construtor padrão da classe.
      * @param arquivo: caminho absoluto para o arquivo desejado.
+     * @param opcoes: combinação das opções SERIES_*.
      */
-    Series(const char* arquivo);
+    Series(const char* arquivo, int opcoes = SERIES_PADRAO);
     ~Series();
 
+    /**
+     * Evitamos que cópias surjam da nossa série.
+     */
+    Series(const Series &) = delete;
+    Series &operator=(const Series &) = delete;
+
     /*
      * @brief Faz a leitura de uma única linha do árquivo, e
-     * escreve os valores para o parâmetro linha.
+     * escreve o momento e os valores dela para o parâmetro linha.
      * @param momento: Momento desejado.
      * @param linha: Linha que será escrito os dados.
      * @return true se nenhum problema ocorreu.
@@ -100,6 +404,42 @@ public:
      */
     bool GetLinhas(Momento de, Momento ate, Lista<Linha> *linhas);
 
+    /*
+     * @brief Visita, em ordem cronológica, as linhas entre dois momentos sem
+     * guardá-las: cada linha é decodificada em um único buffer reaproveitado
+     * e entregue ao visitante assim que é lida.
+     * @param de: Começo de busca.
+     * @param ate: Fim de busca.
+     * @param visitante: função chamada para cada linha; retornar false interrompe a visita.
+     * @return true se alguma linha foi encontrada.
+     *         false se nenhuma linha foi encontrada, ou uma linha não pôde ser lida
+     *         (as linhas anteriores a ela já terão sido visitadas).
+     */
+    bool ParaCada(Momento de, Momento ate, VisitanteLinha visitante);
+
+    /*
+     * @brief Resume as variáveis escolhidas nas linhas entre dois momentos.
+     * @param de: Começo do intervalo.
+     * @param ate: Fim do intervalo.
+     * @param variaveis: máscara com um bit por variável (1 << VARIAVEL_*).
+     * @param agregados: vetor com QUANTIDADE_VARIAVEIS posições; só as
+     * posições das variáveis escolhidas são atualizadas.
+     * @return true se alguma linha foi encontrada.
+     *         false se nenhuma linha foi encontrada, ou houve um problema.
+     */
+    bool Agregar(Momento de, Momento ate, unsigned variaveis, Agregado *agregados);
+
+    /*
+     * @brief Indexa as linhas acrescentadas ao fim do arquivo desde a carga ou
+     * desde a última atualização. Só o trecho novo é lido: uma última linha ainda
+     * sem quebra de linha fica para a próxima chamada.
+     * @param novas: recebe a quantidade de linhas indexadas (opcional).
+     * @return true se o arquivo pôde ser lido, mesmo sem nada novo.
+     *         false se o arquivo não pôde ser lido, ou ficou menor do que
+     *         já foi indexado (nesse caso a série precisa ser carregada de novo).
+     */
+    bool Atualizar(long long *novas = nullptr);
+
     /*
      * @brief Retorna o cabeçalho do arquivo.
      */
@@ -109,11 +449,75 @@ public:
     }
 
     /*
-     * @brief Retorna os dados indexados do arquivo.
+     * @brief Diz se as linhas estão sendo lidas de um arquivo mapeado em memória.
      */
-    inline Arvore<Momento, Coordenada>& GetDados()
+    inline bool IsMapeado() const
+    {
+        return this->mapa.IsAberto() && !this->encolhido;
+    }
+
+    /*
+     * @brief Retorna os dados indexados do arquivo, pelo instante de cada linha.
+     */
+    inline Arvore<Instante, Coordenada>& GetDados()
     {
         return this->dados;
     }
+
+    /*
+     * @brief Retorna o índice horário compacto, em uso quando IsCompacto().
+     */
+    inline IndiceHorario& GetIndiceHorario()
+    {
+        return this->horario;
+    }
+
+    /*
+     * @brief Retorna as colunas com todas as linhas decodificadas, em uso quando IsColunar().
+     */
+    inline const Colunas& GetColunas() const
+    {
+        return this->colunas;
+    }
+
+    /*
+     * @brief Retorna os resumos por dia, mês e ano, em uso quando IsPiramidal().
+     */
+    inline const Piramide& GetPiramide() const
+    {
+        return this->piramide;
+    }
+
+    /*
+     * @brief Diz se os resumos por dia, mês e ano foram calculados.
+     */
+    inline bool IsPiramidal() const
+    {
+        return !this->piramide.IsVazia();
+    }
+
+    /*
+     * @brief Diz se as linhas também estão indexadas por mês do ano e hora do dia.
+     */
+    inline bool IsSazonal() const
+    {
+        return !this->sazonal.IsVazio();
+    }
+
+    /*
+     * @brief Diz se as linhas foram carregadas em colunas na memória.
+     */
+    inline bool IsColunar() const
+    {
+        return this->colunar;
+    }
+
+    /*
+     * @brief Diz se os dados estão indexados pelo índice horário compacto.
+     */
+    inline bool IsCompacto() const
+    {
+        return this->compacto;
+    }
 };
 #endif
\ No newline at end of file
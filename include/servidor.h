@@ -0,0 +1,95 @@
+#ifndef SERVIDOR_H
+#define SERVIDOR_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <serie.h>
+
+// Conexões abertas ao mesmo tempo; as que passam disso são fechadas ao serem aceitas.
+// Fica abaixo do limite usual de 1024 descritores por processo.
+#define SERVIDOR_CONEXOES_MAXIMAS 512
+
+// Segundos que um pedido começado pode levar para chegar inteiro, e uma resposta
+// para ser aceita pelo cliente, antes de a conexão ser fechada.
+#define SERVIDOR_TEMPO_LIMITE 5
+
+/*
+ * Servidor de consultas: mantém séries já carregadas e responde pedidos do
+ * protocolo (protocolo.h) recebidos em um socket Unix.
+ *
+ * Uma thread aceita as conexões e observa (poll) as que estão ociosas; quando
+ * chega um pedido, a conexão vai para uma fila, e um conjunto fixo de
+ * trabalhadores responde um pedido de cada vez e a devolve à observação. Assim
+ * conexões ociosas não ocupam trabalhadores, e as respostas de uma conexão
+ * saem na ordem dos pedidos. As séries são consultadas por todos os
+ * trabalhadores ao mesmo tempo, sem travas.
+ */
+class Servidor
+{
+private:
+    std::string caminho;
+    std::vector<Series *> estacoes;
+    int trabalhadores;
+
+    // Socket que aceita as conexões; -1 enquanto fechado.
+    int escuta = -1;
+
+    // Pipe que acorda o poll de Servir quando um trabalhador devolve uma conexão.
+    int despertador[2] = {-1, -1};
+
+    std::mutex trava;
+    std::condition_variable sinal;
+    std::deque<int> pendentes;   // com um pedido chegando, à espera de um trabalhador
+    std::vector<int> ativas;     // sendo atendidas
+    std::vector<int> devolvidas; // atendidas, a voltar para a observação
+    int conexoes = 0;
+    bool encerrando = false;
+
+    /*
+     * @brief Laço de cada trabalhador: atende pedidos da fila até o encerramento.
+     */
+    void Trabalhar();
+
+    /*
+     * @brief Responde o próximo pedido de uma conexão.
+     * @return false se a conexão terminou, ou não pode mais ser usada.
+     */
+    bool Atender(int conexao);
+
+public:
+    /*
+     * @param caminho: caminho do socket Unix.
+     * @param estacoes: séries atendidas, na ordem das estações dos pedidos. Não
+     * pertencem ao servidor e precisam existir enquanto ele estiver servindo.
+     * @param trabalhadores: quantidade de pedidos atendidos ao mesmo tempo.
+     */
+    Servidor(const char *caminho, const std::vector<Series *> &estacoes, int trabalhadores);
+    ~Servidor();
+
+    Servidor(const Servidor &) = delete;
+    Servidor &operator=(const Servidor &) = delete;
+
+    /*
+     * @brief Cria o socket e começa a escutar. Um socket esquecido por um servidor
+     * que já terminou é substituído; um que ainda responde, não.
+     * @return false se o socket não pôde ser criado.
+     */
+    bool Abrir();
+
+    /*
+     * @brief Aceita e responde conexões até Parar ser chamada. Ao retornar, todos
+     * os trabalhadores terminaram e o socket foi removido.
+     */
+    void Servir();
+
+    /*
+     * @brief Pede o encerramento de Servir. Pode ser chamada de um tratador de sinal.
+     */
+    void Parar();
+};
+
+#endif // !SERVIDOR_H
@@ -0,0 +1,104 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <cstdint>
+
+// Níveis de implementação da varredura de delimitadores.
+#define SIMD_ESCALAR 0
+#define SIMD_SSE2 1
+#define SIMD_AVX2 2
+
+// Quantidade de bytes analisados por vez.
+#define SIMD_TAMANHO_BLOCO 64
+
+/*
+ * @brief Calcula as máscaras de um bloco de 64 bytes: o bit i de 'linhas' indica
+ * que o byte i é '\n', e o bit i de 'campos' indica que o byte i é ';'.
+ * A implementação é escolhida em tempo de execução conforme o processador.
+ */
+void MascararBloco(const char *bloco, uint64_t *linhas, uint64_t *campos);
+
+/*
+ * @brief Retorna o nível de implementação em uso (SIMD_*).
+ */
+int SimdGetNivel();
+
+/*
+ * @brief Força um nível de implementação, limitado ao que o processador suporta.
+ * Útil para comparar as implementações.
+ * @return O nível efetivamente em uso.
+ */
+int SimdDefinirNivel(int nivel);
+
+/*
+ * @brief Nome legível de um nível de implementação.
+ */
+const char *SimdGetNome(int nivel);
+
+/*
+ * Percorre, em ordem, os delimitadores (';' e '\n') de um trecho de memória,
+ * analisando 64 bytes de cada vez.
+ */
+class Varredor
+{
+private:
+    const char *bloco;
+    const char *fim;
+
+    // Delimitadores ainda não visitados do bloco atual.
+    uint64_t linhas;
+    uint64_t campos;
+
+    void carregar(const char *inicio);
+
+public:
+    Varredor(const char *inicio, const char *fim);
+
+    /*
+     * @brief Retorna o próximo delimitador (';' ou '\n'), ou 'fim' se não houver.
+     */
+    inline const char *Proximo()
+    {
+        while ((linhas | campos) == 0)
+        {
+            if (bloco + SIMD_TAMANHO_BLOCO >= fim)
+                return fim;
+            carregar(bloco + SIMD_TAMANHO_BLOCO);
+        }
+
+        uint64_t todos = linhas | campos;
+        uint64_t bit = todos & (~todos + 1);
+        linhas &= ~bit;
+        campos &= ~bit;
+
+        return bloco + __builtin_ctzll(todos);
+    }
+
+    /*
+     * @brief Retorna a próxima quebra de linha, ou 'fim' se não houver,
+     * descartando os ';' que ficarem pelo caminho.
+     */
+    inline const char *ProximaQuebra()
+    {
+        while (linhas == 0)
+        {
+            if (bloco + SIMD_TAMANHO_BLOCO >= fim)
+            {
+                campos = 0;
+                return fim;
+            }
+            carregar(bloco + SIMD_TAMANHO_BLOCO);
+        }
+
+        int posicao = __builtin_ctzll(linhas);
+        uint64_t ate = (linhas & (~linhas + 1));
+
+        // Descartamos a quebra e todos os delimitadores antes dela.
+        linhas &= ~ate;
+        campos &= ~((ate << 1) - 1);
+
+        return bloco + posicao;
+    }
+};
+
+#endif // !SIMD_H
@@ -0,0 +1,63 @@
+#ifndef TABELA_H
+#define TABELA_H
+
+#include <agregacao.h>
+#include <saida.h>
+#include <serie.h>
+
+// Formatos da tabela de resultados.
+#define TABELA_ALINHADA 0
+#define TABELA_CSV 1
+#define TABELA_TSV 2
+
+// Colunas do momento (dia, mês, ano, hora e minuto) antes das variáveis.
+#define TABELA_COLUNAS_MOMENTO 5
+
+/*
+ * Desenha a tabela de resultados em uma Saida. Os números são formatados com
+ * std::to_chars direto no buffer da saída, então cada linha custa poucas cópias
+ * de memória e a escrita no terminal acontece em blocos grandes.
+ *
+ * No formato alinhado as colunas têm largura fixa, e o rodapé traz o resumo do
+ * intervalo. Em CSV e TSV só saem o nome das colunas e os valores, sem o
+ * rodapé, para que o resultado possa ser lido por outros programas.
+ * Valores ausentes ficam em branco em todos os formatos.
+ */
+class Tabela
+{
+private:
+    Saida &saida;
+    int formato;
+    char separador;
+
+    void escreverCelula(const char *texto, int largura);
+    void escreverInteiro(long long valor, int largura);
+    void escreverValor(double valor, int largura);
+    void escreverRotulo(const char *rotulo);
+    void escreverSeparador();
+    void escreverLinhaDivisoria();
+
+public:
+    /*
+     * @param formato: TABELA_ALINHADA, TABELA_CSV ou TABELA_TSV.
+     */
+    Tabela(Saida &saida, int formato);
+
+    /*
+     * @brief Escreve o nome (e, se alinhada, a unidade) de cada coluna.
+     */
+    void EscreverCabecalho();
+
+    /*
+     * @brief Escreve uma linha de dados.
+     */
+    void EscreverLinha(const Linha &linha);
+
+    /*
+     * @brief Escreve o resumo das variáveis. Só no formato alinhado.
+     * @param agregados: vetor com QUANTIDADE_VARIAVEIS posições, indexado por VARIAVEL_*.
+     */
+    void EscreverRodape(const Agregado *agregados);
+};
+
+#endif // !TABELA_H
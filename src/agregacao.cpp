@@ -0,0 +1,153 @@
+#include "agregacao.h"
+
+#include <simd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define AGREGACAO_X86
+#endif
+
+static void agregarEscalar(const double *valores, long long quantidade, Agregado *agregado)
+{
+    long long validos = 0;
+    double soma = 0, minimo = agregado->minimo, maximo = agregado->maximo;
+
+    for (long long i = 0; i < quantidade; i++)
+    {
+        double v = valores[i];
+        if (v != v) // NaN: valor ausente.
+            continue;
+
+        validos++;
+        soma += v;
+        if (v < minimo)
+            minimo = v;
+        if (v > maximo)
+            maximo = v;
+    }
+
+    agregado->quantidade += quantidade;
+    agregado->validos += validos;
+    agregado->soma += soma;
+    agregado->minimo = minimo;
+    agregado->maximo = maximo;
+}
+
+#ifdef AGREGACAO_X86
+/*
+ * Nos kernels vetoriais, min/max retornam o segundo operando quando o primeiro
+ * é NaN, então os ausentes não precisam de máscara ali. A contagem de válidos
+ * subtrai a máscara de comparação (-1 por valor presente) de um acumulador.
+ */
+__attribute__((target("sse2"))) static void agregarSse2(const double *valores, long long quantidade, Agregado *agregado)
+{
+    const __m128d zero = _mm_setzero_pd();
+
+    // Dois acumuladores independentes para esconder a latência das somas.
+    __m128d soma_a = zero, soma_b = zero;
+    __m128d minimo = _mm_set1_pd(std::numeric_limits<double>::infinity());
+    __m128d maximo = _mm_set1_pd(-std::numeric_limits<double>::infinity());
+    __m128i validos = _mm_setzero_si128();
+
+    long long i = 0;
+    for (; i + 4 <= quantidade; i += 4)
+    {
+        __m128d a = _mm_loadu_pd(valores + i);
+        __m128d b = _mm_loadu_pd(valores + i + 2);
+        __m128d presente_a = _mm_cmpord_pd(a, a);
+        __m128d presente_b = _mm_cmpord_pd(b, b);
+
+        soma_a = _mm_add_pd(soma_a, _mm_and_pd(presente_a, a));
+        soma_b = _mm_add_pd(soma_b, _mm_and_pd(presente_b, b));
+
+        minimo = _mm_min_pd(a, minimo);
+        minimo = _mm_min_pd(b, minimo);
+        maximo = _mm_max_pd(a, maximo);
+        maximo = _mm_max_pd(b, maximo);
+
+        validos = _mm_sub_epi64(validos, _mm_castpd_si128(presente_a));
+        validos = _mm_sub_epi64(validos, _mm_castpd_si128(presente_b));
+    }
+
+    double s[2], mn[2], mx[2];
+    long long v[2];
+    _mm_storeu_pd(s, _mm_add_pd(soma_a, soma_b));
+    _mm_storeu_pd(mn, minimo);
+    _mm_storeu_pd(mx, maximo);
+    _mm_storeu_si128((__m128i *)v, validos);
+
+    Agregado parcial;
+    parcial.quantidade = i;
+    parcial.validos = v[0] + v[1];
+    parcial.soma = s[0] + s[1];
+    parcial.minimo = mn[0] < mn[1] ? mn[0] : mn[1];
+    parcial.maximo = mx[0] > mx[1] ? mx[0] : mx[1];
+
+    agregado->Combinar(parcial);
+    agregarEscalar(valores + i, quantidade - i, agregado);
+}
+
+__attribute__((target("avx2"))) static void agregarAvx2(const double *valores, long long quantidade, Agregado *agregado)
+{
+    const __m256d zero = _mm256_setzero_pd();
+
+    __m256d soma_a = zero, soma_b = zero;
+    __m256d minimo = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+    __m256d maximo = _mm256_set1_pd(-std::numeric_limits<double>::infinity());
+    __m256i validos = _mm256_setzero_si256();
+
+    long long i = 0;
+    for (; i + 8 <= quantidade; i += 8)
+    {
+        __m256d a = _mm256_loadu_pd(valores + i);
+        __m256d b = _mm256_loadu_pd(valores + i + 4);
+        __m256d presente_a = _mm256_cmp_pd(a, a, _CMP_ORD_Q);
+        __m256d presente_b = _mm256_cmp_pd(b, b, _CMP_ORD_Q);
+
+        soma_a = _mm256_add_pd(soma_a, _mm256_and_pd(presente_a, a));
+        soma_b = _mm256_add_pd(soma_b, _mm256_and_pd(presente_b, b));
+
+        minimo = _mm256_min_pd(a, minimo);
+        minimo = _mm256_min_pd(b, minimo);
+        maximo = _mm256_max_pd(a, maximo);
+        maximo = _mm256_max_pd(b, maximo);
+
+        validos = _mm256_sub_epi64(validos, _mm256_castpd_si256(presente_a));
+        validos = _mm256_sub_epi64(validos, _mm256_castpd_si256(presente_b));
+    }
+
+    double s[4], mn[4], mx[4];
+    long long v[4];
+    _mm256_storeu_pd(s, _mm256_add_pd(soma_a, soma_b));
+    _mm256_storeu_pd(mn, minimo);
+    _mm256_storeu_pd(mx, maximo);
+    _mm256_storeu_si256((__m256i *)v, validos);
+
+    Agregado parcial;
+    parcial.quantidade = i;
+    parcial.validos = (v[0] + v[1]) + (v[2] + v[3]);
+    parcial.soma = (s[0] + s[1]) + (s[2] + s[3]);
+    for (int j = 0; j < 4; j++)
+    {
+        if (mn[j] < parcial.minimo)
+            parcial.minimo = mn[j];
+        if (mx[j] > parcial.maximo)
+            parcial.maximo = mx[j];
+    }
+
+    agregado->Combinar(parcial);
+    agregarEscalar(valores + i, quantidade - i, agregado);
+}
+#endif
+
+void AgregarColuna(const double *valores, long long quantidade, Agregado *agregado)
+{
+#ifdef AGREGACAO_X86
+    int nivel = SimdGetNivel();
+    if (nivel == SIMD_AVX2)
+        return agregarAvx2(valores, quantidade, agregado);
+    if (nivel == SIMD_SSE2)
+        return agregarSse2(valores, quantidade, agregado);
+#endif
+    agregarEscalar(valores, quantidade, agregado);
+}
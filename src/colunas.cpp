@@ -0,0 +1,59 @@
+#include "colunas.h"
+
+void Colunas::Reservar(long long quantidade)
+{
+    instantes.reserve(quantidade);
+    for (std::vector<double> &coluna : valores)
+        coluna.reserve(quantidade);
+}
+
+void Colunas::Adicionar(const Momento &momento, const double *linha)
+{
+    instantes.push_back(momento.GetInstante());
+    for (int i = 0; i < QUANTIDADE_VARIAVEIS; i++)
+        valores[i].push_back(linha[i]);
+}
+
+void Colunas::SubstituirUltima(const double *linha)
+{
+    if (instantes.empty())
+        return;
+
+    for (int i = 0; i < QUANTIDADE_VARIAVEIS; i++)
+        valores[i].back() = linha[i];
+}
+
+void Colunas::Limpar()
+{
+    instantes.clear();
+    for (std::vector<double> &coluna : valores)
+        coluna.clear();
+}
+
+long long Colunas::LimiteInferior(Instante instante) const
+{
+    long long inicio = 0, fim = GetQuantidade();
+    while (inicio < fim)
+    {
+        long long meio = inicio + (fim - inicio) / 2;
+        if (instantes[meio] < instante)
+            inicio = meio + 1;
+        else
+            fim = meio;
+    }
+    return inicio;
+}
+
+long long Colunas::LimiteSuperior(Instante instante) const
+{
+    long long inicio = 0, fim = GetQuantidade();
+    while (inicio < fim)
+    {
+        long long meio = inicio + (fim - inicio) / 2;
+        if (instantes[meio] > instante)
+            fim = meio;
+        else
+            inicio = meio + 1;
+    }
+    return inicio;
+}
@@ -0,0 +1,342 @@
+#include "consulta.h"
+
+#include <cctype>
+#include <string>
+
+#include <analisador.h>
+#include <rastreio.h>
+
+/*
+ * @brief Lê um campo de momento: dígitos, ou '*' para ignorar o campo.
+ */
+static bool analisarCampo(const char *inicio, const char *fim, int *valor)
+{
+    if (fim - inicio == 1 && *inicio == '*')
+    {
+        *valor = MOMENTO_DONT_COMPARE;
+        return true;
+    }
+
+    if (inicio == fim || fim - inicio > 9)
+        return false;
+
+    return AnalisarDigitos(inicio, (int)(fim - inicio), valor);
+}
+
+bool AnalisarMomento(const char *inicio, const char *fim, Momento *momento)
+{
+    // Ano, mês, dia, hora e minuto; os que não aparecem ficam ignorados.
+    int campos[5] = {MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE,
+                     MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE};
+    static const char separadores[4] = {'-', '-', 'T', ':'};
+
+    const char *p = inicio;
+    for (int i = 0; i < 5 && p < fim; i++)
+    {
+        const char *q = p;
+        while (q < fim && (isdigit((unsigned char)*q) || *q == '*'))
+            q++;
+
+        if (!analisarCampo(p, q, &campos[i]))
+            return false;
+
+        if (q == fim)
+        {
+            p = q;
+            break;
+        }
+
+        // Aceitamos também '/' e ' ' nas posições de data e de hora.
+        if (i == 4 || !(*q == separadores[i] || *q == '/' || (i == 2 && *q == ' ')))
+            return false;
+        p = q + 1;
+    }
+
+    if (p != fim)
+        return false;
+
+    static const int minimos[5] = {0, 1, 1, 0, 0};
+    static const int maximos[5] = {999999, 12, 31, 23, 59};
+    for (int i = 0; i < 5; i++)
+    {
+        if (campos[i] != MOMENTO_DONT_COMPARE && (campos[i] < minimos[i] || campos[i] > maximos[i]))
+            return false;
+    }
+
+    // Datas impossíveis virariam instantes de outros dias, como em AnalisarData. Sem
+    // ano, vale o maior mês possível (29 de fevereiro existe em algum ano).
+    if (campos[1] != MOMENTO_DONT_COMPARE && campos[2] != MOMENTO_DONT_COMPARE &&
+        campos[2] > DiasNoMes(campos[1], campos[0] != MOMENTO_DONT_COMPARE ? campos[0] : 2000))
+        return false;
+
+    *momento = Momento(campos[2], campos[1], campos[0], campos[3], campos[4]);
+    return true;
+}
+
+/*
+ * @brief Avança 'p' até o começo da próxima palavra e retorna o fim dela.
+ */
+static const char *proximaPalavra(const char *&p, const char *fim)
+{
+    while (p < fim && isspace((unsigned char)*p))
+        p++;
+
+    const char *q = p;
+    while (q < fim && !isspace((unsigned char)*q))
+        q++;
+    return q;
+}
+
+bool AnalisarConsulta(const char *inicio, const char *fim, Consulta *consulta, const char **erro)
+{
+    *erro = nullptr;
+
+    const char *p = inicio;
+    const char *q = proximaPalavra(p, fim);
+    if (p == q || *p == '#')
+        return false;
+
+    std::string comando(p, q);
+    if (comando == "linha")
+        consulta->tipo = CONSULTA_LINHA;
+    else if (comando == "linhas")
+        consulta->tipo = CONSULTA_LINHAS;
+    else if (comando == "resumo")
+        consulta->tipo = CONSULTA_RESUMO;
+    else
+    {
+        *erro = "comando desconhecido (use linha, linhas ou resumo)";
+        return false;
+    }
+
+    p = q;
+    q = proximaPalavra(p, fim);
+    if (p == q || !AnalisarMomento(p, q, &consulta->de))
+    {
+        *erro = "momento inicial invalido";
+        return false;
+    }
+
+    consulta->ate = consulta->de;
+
+    p = q;
+    q = proximaPalavra(p, fim);
+    if (p != q)
+    {
+        if (consulta->tipo == CONSULTA_LINHA)
+        {
+            *erro = "a consulta 'linha' recebe um unico momento";
+            return false;
+        }
+
+        if (!AnalisarMomento(p, q, &consulta->ate))
+        {
+            *erro = "momento final invalido";
+            return false;
+        }
+
+        p = q;
+        q = proximaPalavra(p, fim);
+        if (p != q)
+        {
+            *erro = "texto sobrando depois da consulta";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void escreverDoisDigitos(int valor, Saida &saida)
+{
+    saida.Escrever((char)('0' + valor / 10));
+    saida.Escrever((char)('0' + valor % 10));
+}
+
+static void escreverMomento(const Momento &momento, Saida &saida)
+{
+    saida.EscreverInteiro(momento.data.ano);
+    saida.Escrever('-');
+    escreverDoisDigitos(momento.data.mes, saida);
+    saida.Escrever('-');
+    escreverDoisDigitos(momento.data.dia, saida);
+    saida.Escrever('T');
+    escreverDoisDigitos(momento.horario.hora, saida);
+    saida.Escrever(':');
+    escreverDoisDigitos(momento.horario.minuto, saida);
+}
+
+/*
+ * @brief Escreve um valor que pode estar ausente: vazio em CSV, null em JSON.
+ */
+static void escreverValor(double valor, int formato, Saida &saida, int casas = -1)
+{
+    if (valor != valor)
+    {
+        if (formato == FORMATO_JSON)
+            saida.Escrever("null", 4);
+    }
+    else if (casas >= 0)
+        saida.EscreverDecimal(valor, casas);
+    else
+        saida.EscreverDecimal(valor);
+}
+
+static void escreverInicio(long long numero, const char *tipo, int formato, Saida &saida)
+{
+    if (formato == FORMATO_JSON)
+    {
+        saida.Escrever("{\"consulta\":");
+        saida.EscreverInteiro(numero);
+        saida.Escrever(",\"tipo\":\"");
+        saida.Escrever(tipo);
+        saida.Escrever('"');
+    }
+    else
+    {
+        saida.EscreverInteiro(numero);
+        saida.Escrever(',');
+        saida.Escrever(tipo);
+    }
+}
+
+/*
+ * @brief Escreve o separador e, em JSON, o nome de um campo.
+ */
+static void escreverCampo(const char *nome, int formato, Saida &saida)
+{
+    saida.Escrever(',');
+    if (formato == FORMATO_JSON)
+    {
+        saida.Escrever('"');
+        saida.Escrever(nome);
+        saida.Escrever("\":", 2);
+    }
+}
+
+static void escreverLinha(const Linha &linha, long long numero, int formato, Saida &saida)
+{
+    escreverInicio(numero, "linha", formato, saida);
+
+    escreverCampo("momento", formato, saida);
+    if (formato == FORMATO_JSON)
+        saida.Escrever('"');
+    escreverMomento(linha.momento, saida);
+    if (formato == FORMATO_JSON)
+        saida.Escrever('"');
+
+    for (int i = 0; i < QUANTIDADE_VARIAVEIS; i++)
+    {
+        escreverCampo(NOMES_VARIAVEIS[i], formato, saida);
+        escreverValor(linha.*VARIAVEIS_LINHA[i], formato, saida);
+    }
+
+    if (formato == FORMATO_JSON)
+        saida.Escrever('}');
+    saida.Escrever('\n');
+}
+
+static void escreverVazio(long long numero, int formato, Saida &saida)
+{
+    escreverInicio(numero, "vazio", formato, saida);
+    if (formato == FORMATO_JSON)
+        saida.Escrever('}');
+    saida.Escrever('\n');
+}
+
+static void escreverResumo(const Agregado &agregado, int variavel, long long numero, int formato, Saida &saida)
+{
+    escreverInicio(numero, "resumo", formato, saida);
+
+    escreverCampo("variavel", formato, saida);
+    if (formato == FORMATO_JSON)
+        saida.Escrever('"');
+    saida.Escrever(NOMES_VARIAVEIS[variavel]);
+    if (formato == FORMATO_JSON)
+        saida.Escrever('"');
+
+    escreverCampo("quantidade", formato, saida);
+    saida.EscreverInteiro(agregado.quantidade);
+    escreverCampo("validos", formato, saida);
+    saida.EscreverInteiro(agregado.validos);
+    escreverCampo("soma", formato, saida);
+    saida.EscreverDecimal(agregado.soma, CONSULTA_CASAS_RESUMO);
+    escreverCampo("media", formato, saida);
+    escreverValor(agregado.GetMedia(), formato, saida, CONSULTA_CASAS_RESUMO);
+    escreverCampo("minimo", formato, saida);
+    escreverValor(agregado.GetMinimo(), formato, saida);
+    escreverCampo("maximo", formato, saida);
+    escreverValor(agregado.GetMaximo(), formato, saida);
+
+    if (formato == FORMATO_JSON)
+        saida.Escrever('}');
+    saida.Escrever('\n');
+}
+
+long long ExecutarConsulta(Series &series, const Consulta &consulta, long long numero, int formato, Saida &saida)
+{
+    RASTREAR("Consulta");
+
+    switch (consulta.tipo)
+    {
+    case CONSULTA_LINHA:
+    {
+        Linha linha;
+        if (!series.GetLinha(consulta.de, &linha))
+        {
+            escreverVazio(numero, formato, saida);
+            return 1;
+        }
+
+        escreverLinha(linha, numero, formato, saida);
+        return 1;
+    }
+    case CONSULTA_LINHAS:
+    {
+        long long registros = 0;
+        bool lidas = series.ParaCada(consulta.de, consulta.ate, [&](const Linha &linha) -> bool
+                                     {
+                                         escreverLinha(linha, numero, formato, saida);
+                                         registros++;
+                                         return true;
+                                     });
+
+        // Sem linhas, o intervalo está vazio. Com linhas, a visita parou numa linha
+        // que não pôde ser lida, e quem lê a saída precisa saber que ela está incompleta.
+        if (registros == 0)
+        {
+            escreverVazio(numero, formato, saida);
+            return 1;
+        }
+        if (!lidas)
+        {
+            EscreverErro(numero, "linha ilegivel no arquivo", formato, saida);
+            registros++;
+        }
+        return registros;
+    }
+    default:
+    {
+        // Um intervalo sem linhas ainda gera o resumo, com quantidade zero.
+        Agregado agregados[QUANTIDADE_VARIAVEIS];
+        series.Agregar(consulta.de, consulta.ate, VARIAVEIS_TODAS, agregados);
+
+        for (int i = 0; i < QUANTIDADE_VARIAVEIS; i++)
+            escreverResumo(agregados[i], i, numero, formato, saida);
+        return QUANTIDADE_VARIAVEIS;
+    }
+    }
+}
+
+void EscreverErro(long long numero, const char *mensagem, int formato, Saida &saida)
+{
+    escreverInicio(numero, "erro", formato, saida);
+
+    escreverCampo("mensagem", formato, saida);
+    if (formato == FORMATO_JSON)
+        saida.Escrever('"');
+    saida.Escrever(mensagem);
+    if (formato == FORMATO_JSON)
+        saida.Escrever("\"}", 2);
+    saida.Escrever('\n');
+}
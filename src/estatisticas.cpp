@@ -0,0 +1,162 @@
+#include "estatisticas.h"
+
+#include <atomic>
+
+static const char *const nomes_contadores[QUANTIDADE_CONTADORES] = {
+    "linhas_indexadas", "linhas_invalidas", "linhas_decodificadas", "falhas_leitura",
+    "bytes_lidos", "bytes_indexados", "seeks"};
+
+static const char *const nomes_tempos[QUANTIDADE_TEMPOS] = {
+    "Inicializar", "LerLinha", "GetLinha", "GetLinhas", "ParaCada", "Agregar"};
+
+/*
+ * Durações registradas em um cronômetro.
+ */
+typedef struct Cronometro
+{
+    std::atomic<uint64_t> chamadas;
+    std::atomic<uint64_t> total;
+    std::atomic<uint64_t> maximo;
+    std::atomic<uint64_t> baldes[ESTATISTICAS_BALDES];
+} Cronometro;
+
+static std::atomic<uint64_t> contadores[QUANTIDADE_CONTADORES];
+static Cronometro cronometros[QUANTIDADE_TEMPOS];
+
+void EstatisticasSomar(int contador, uint64_t valor)
+{
+    contadores[contador].fetch_add(valor, std::memory_order_relaxed);
+}
+
+void EstatisticasRegistrar(int tempo, uint64_t nanossegundos, uint64_t peso)
+{
+    Cronometro &cronometro = cronometros[tempo];
+
+    int balde = nanossegundos == 0 ? 0 : 64 - __builtin_clzll(nanossegundos);
+    if (balde >= ESTATISTICAS_BALDES)
+        balde = ESTATISTICAS_BALDES - 1;
+
+    cronometro.chamadas.fetch_add(peso, std::memory_order_relaxed);
+    cronometro.total.fetch_add(nanossegundos * peso, std::memory_order_relaxed);
+    cronometro.baldes[balde].fetch_add(peso, std::memory_order_relaxed);
+
+    uint64_t maximo = cronometro.maximo.load(std::memory_order_relaxed);
+    while (nanossegundos > maximo &&
+           !cronometro.maximo.compare_exchange_weak(maximo, nanossegundos, std::memory_order_relaxed))
+        ;
+}
+
+bool EstatisticasAtivas()
+{
+#ifdef SERIES_ESTATISTICAS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void EstatisticasLimpar()
+{
+    for (std::atomic<uint64_t> &contador : contadores)
+        contador.store(0, std::memory_order_relaxed);
+
+    for (Cronometro &cronometro : cronometros)
+    {
+        cronometro.chamadas.store(0, std::memory_order_relaxed);
+        cronometro.total.store(0, std::memory_order_relaxed);
+        cronometro.maximo.store(0, std::memory_order_relaxed);
+        for (std::atomic<uint64_t> &balde : cronometro.baldes)
+            balde.store(0, std::memory_order_relaxed);
+    }
+}
+
+/*
+ * @brief Estimativa de um percentil (0 a 1) pelo histograma: o limite superior
+ * do balde em que ele cai, limitado ao maior valor registrado.
+ */
+static uint64_t percentil(const Cronometro &cronometro, double p)
+{
+    uint64_t chamadas = cronometro.chamadas.load(std::memory_order_relaxed);
+    if (chamadas == 0)
+        return 0;
+
+    uint64_t alvo = (uint64_t)(p * chamadas);
+    if (alvo >= chamadas)
+        alvo = chamadas - 1;
+
+    uint64_t acumulado = 0;
+    uint64_t maximo = cronometro.maximo.load(std::memory_order_relaxed);
+    for (int b = 0; b < ESTATISTICAS_BALDES; b++)
+    {
+        acumulado += cronometro.baldes[b].load(std::memory_order_relaxed);
+        if (acumulado > alvo)
+        {
+            uint64_t limite = b == 0 ? 0 : (1ULL << b) - 1;
+            return limite < maximo ? limite : maximo;
+        }
+    }
+    return maximo;
+}
+
+void EstatisticasImprimir(FILE *arquivo)
+{
+    if (!EstatisticasAtivas())
+    {
+        fprintf(arquivo, "Estatísticas desativadas nesta compilação (SERIES_ESTATISTICAS).\n");
+        return;
+    }
+
+    fprintf(arquivo, "\nEstatísticas:\n");
+    for (int c = 0; c < QUANTIDADE_CONTADORES; c++)
+        fprintf(arquivo, "  %-26s %16llu\n", nomes_contadores[c],
+                (unsigned long long)contadores[c].load(std::memory_order_relaxed));
+
+    fprintf(arquivo, "  %-16s %10s %12s %12s %12s %12s %12s %12s\n", "tempo", "chamadas", "total ms", "media us",
+            "p50 us", "p90 us", "p99 us", "max us");
+    for (int t = 0; t < QUANTIDADE_TEMPOS; t++)
+    {
+        const Cronometro &cronometro = cronometros[t];
+        uint64_t chamadas = cronometro.chamadas.load(std::memory_order_relaxed);
+        if (chamadas == 0)
+            continue;
+
+        double total = (double)cronometro.total.load(std::memory_order_relaxed);
+        char nome[32];
+        if (AMOSTRAGEM_TEMPOS[t] > 1)
+            snprintf(nome, sizeof(nome), "%s (1/%u)", nomes_tempos[t], AMOSTRAGEM_TEMPOS[t]);
+        else
+            snprintf(nome, sizeof(nome), "%s", nomes_tempos[t]);
+
+        fprintf(arquivo, "  %-16s %10llu %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f\n", nome,
+                (unsigned long long)chamadas, total / 1e6, total / chamadas / 1e3, percentil(cronometro, 0.50) / 1e3,
+                percentil(cronometro, 0.90) / 1e3, percentil(cronometro, 0.99) / 1e3,
+                cronometro.maximo.load(std::memory_order_relaxed) / 1e3);
+    }
+}
+
+void EstatisticasImprimirJson(FILE *arquivo)
+{
+    fprintf(arquivo, "{\"ativas\":%s,\"contadores\":{", EstatisticasAtivas() ? "true" : "false");
+    for (int c = 0; c < QUANTIDADE_CONTADORES; c++)
+        fprintf(arquivo, "%s\"%s\":%llu", c ? "," : "", nomes_contadores[c],
+                (unsigned long long)contadores[c].load(std::memory_order_relaxed));
+
+    fprintf(arquivo, "},\"tempos\":{");
+    for (int t = 0; t < QUANTIDADE_TEMPOS; t++)
+    {
+        const Cronometro &cronometro = cronometros[t];
+        fprintf(arquivo, "%s\"%s\":{\"amostragem\":%u,\"chamadas\":%llu,\"total_ns\":%llu,\"max_ns\":%llu,"
+                         "\"p50_ns\":%llu,\"p90_ns\":%llu,\"p99_ns\":%llu,\"baldes\":[",
+                t ? "," : "", nomes_tempos[t], AMOSTRAGEM_TEMPOS[t],
+                (unsigned long long)cronometro.chamadas.load(std::memory_order_relaxed),
+                (unsigned long long)cronometro.total.load(std::memory_order_relaxed),
+                (unsigned long long)cronometro.maximo.load(std::memory_order_relaxed),
+                (unsigned long long)percentil(cronometro, 0.50), (unsigned long long)percentil(cronometro, 0.90),
+                (unsigned long long)percentil(cronometro, 0.99));
+
+        for (int b = 0; b < ESTATISTICAS_BALDES; b++)
+            fprintf(arquivo, "%s%llu", b ? "," : "", (unsigned long long)cronometro.baldes[b].load(std::memory_order_relaxed));
+        fprintf(arquivo, "]}");
+    }
+    fprintf(arquivo, "}}\n");
+}
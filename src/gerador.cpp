@@ -0,0 +1,200 @@
+#include "gerador.h"
+
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <momento.h>
+#include <saida.h>
+
+// Duração média (em horas) de uma lacuna.
+#define GERADOR_LACUNA_MEDIA 24
+
+// Chance de uma linha vazia depois de cada linha, com GERADOR_LINHAS_VAZIAS.
+#define GERADOR_CHANCE_LINHA_VAZIA 0.01
+
+// Chance de não chover em uma hora; com chuva, a precipitação é sorteada.
+#define GERADOR_CHANCE_SEM_CHUVA 0.8
+
+/*
+ * Faixa de valores de cada variável, em décimos, na ordem do INMET.
+ */
+static const struct
+{
+    int minimo;
+    int maximo;
+} faixas[GERADOR_VARIAVEIS] = {
+    {0, 300},       // precipitação total (mm)
+    {8800, 10200},  // pressão atmosférica (mB)
+    {8800, 10200},  // pressão máxima
+    {8800, 10200},  // pressão mínima
+    {0, 40000},     // radiação global (Kj/m²)
+    {-50, 400},     // temperatura do ar (°C)
+    {-100, 300},    // temperatura do orvalho
+    {-50, 400},     // temperatura máxima
+    {-50, 400},     // temperatura mínima
+    {-100, 300},    // orvalho máximo
+    {-100, 300},    // orvalho mínimo
+    {100, 1000},    // umidade máxima (%)
+    {100, 1000},    // umidade mínima
+    {100, 1000},    // umidade relativa
+    {0, 3600},      // direção do vento (°)
+    {0, 300},       // rajada (m/s)
+    {0, 150},       // velocidade do vento
+};
+
+OpcoesGerador GetOpcoesGeradorPadrao(int anos)
+{
+    OpcoesGerador opcoes;
+    opcoes.ano_inicial = 2025 - anos;
+    opcoes.ano_final = 2024;
+    opcoes.ausentes = 0.05;
+    opcoes.lacunas = 0;
+    opcoes.variantes = GERADOR_PADRAO;
+    opcoes.estacao = 1;
+    opcoes.semente = 42;
+    return opcoes;
+}
+
+static void escreverCabecalho(const OpcoesGerador &opcoes, const char *quebra, Saida &saida)
+{
+    char texto[256];
+
+    snprintf(texto, sizeof(texto),
+             "REGIAO:;CO%s" "UF:;DF%s" "ESTACAO:;ESTACAO %04d%s" "CODIGO (WMO):;A%04d%s"
+             "LATITUDE:;-15,78%s" "LONGITUDE:;-47,92%s" "ALTITUDE:;1160,96%s" "DATA DE FUNDACAO:;07/05/00%s",
+             quebra, quebra, opcoes.estacao, quebra, opcoes.estacao, quebra, quebra, quebra, quebra, quebra);
+    saida.Escrever(texto);
+
+    saida.Escrever("Data;Hora UTC;PRECIPITACAO TOTAL, HORARIO (mm);PRESSAO ATMOSFERICA AO NIVEL DA ESTACAO, HORARIA (mB);"
+                   "PRESSAO ATMOSFERICA MAX.NA HORA ANT. (AUT) (mB);PRESSAO ATMOSFERICA MIN. NA HORA ANT. (AUT) (mB);"
+                   "RADIACAO GLOBAL (Kj/m2);TEMPERATURA DO AR - BULBO SECO, HORARIA (C);TEMPERATURA DO PONTO DE ORVALHO (C);"
+                   "TEMPERATURA MAXIMA NA HORA ANT. (AUT) (C);TEMPERATURA MINIMA NA HORA ANT. (AUT) (C);"
+                   "TEMPERATURA ORVALHO MAX. NA HORA ANT. (AUT) (C);TEMPERATURA ORVALHO MIN. NA HORA ANT. (AUT) (C);"
+                   "UMIDADE REL. MAX. NA HORA ANT. (AUT) (%);UMIDADE REL. MIN. NA HORA ANT. (AUT) (%);"
+                   "UMIDADE RELATIVA DO AR, HORARIA (%);VENTO, DIRECAO HORARIA (gr);VENTO, RAJADA MAXIMA (m/s);"
+                   "VENTO, VELOCIDADE HORARIA (m/s);");
+    saida.Escrever(quebra);
+}
+
+/*
+ * @brief Escreve um valor em décimos, como "-12,5".
+ */
+static inline void escreverDecimos(int decimos, char virgula, Saida &saida)
+{
+    if (decimos < 0)
+    {
+        saida.Escrever('-');
+        decimos = -decimos;
+    }
+    saida.EscreverInteiro(decimos / 10);
+    saida.Escrever(virgula);
+    saida.Escrever((char)('0' + decimos % 10));
+}
+
+bool GerarArquivo(const char *caminho, const OpcoesGerador &opcoes, long long *linhas, long long *bytes)
+{
+    int descritor = open(caminho, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (descritor < 0)
+        return false;
+
+    long long escritas = 0;
+    bool ok;
+    {
+        Saida saida(descritor);
+        Sorteio sorteio(opcoes.semente * 1000003 + (uint64_t)opcoes.estacao);
+        const char *quebra = (opcoes.variantes & GERADOR_CRLF) ? "\r\n" : "\n";
+        size_t tamanho_quebra = (opcoes.variantes & GERADOR_CRLF) ? 2 : 1;
+
+        escreverCabecalho(opcoes, quebra, saida);
+
+        // As 24 horas nos dois formatos, prontas para copiar.
+        char horas_utc[24][9], horas_dois_pontos[24][6];
+        for (int h = 0; h < 24; h++)
+        {
+            snprintf(horas_utc[h], sizeof(horas_utc[h]), "%02d00 UTC", h);
+            snprintf(horas_dois_pontos[h], sizeof(horas_dois_pontos[h]), "%02d:00", h);
+        }
+
+        long long primeiro = DiasDesdeEpoca(1, 1, opcoes.ano_inicial);
+        long long ultimo = DiasDesdeEpoca(31, 12, opcoes.ano_final);
+        double chance_lacuna = opcoes.lacunas / GERADOR_LACUNA_MEDIA;
+        long long lacuna = 0;
+        bool pendente = false;
+
+        for (long long dia = primeiro; dia <= ultimo; dia++)
+        {
+            Data data = DataDeDias(dia);
+            char datas[2][11];
+            snprintf(datas[0], sizeof(datas[0]), "%04d/%02d/%02d", data.ano, data.mes, data.dia);
+            snprintf(datas[1], sizeof(datas[1]), "%04d-%02d-%02d", data.ano, data.mes, data.dia);
+
+            for (int h = 0; h < 24; h++)
+            {
+                // Dentro de uma lacuna a hora não tem linha.
+                if (lacuna > 0 || (chance_lacuna > 0 && sorteio.Fracao() < chance_lacuna))
+                {
+                    if (lacuna == 0)
+                        lacuna = sorteio.Entre(1, 2 * GERADOR_LACUNA_MEDIA - 1);
+                    lacuna--;
+                    continue;
+                }
+
+                int variantes = opcoes.variantes;
+                if (variantes & GERADOR_MISTURAR)
+                {
+                    int sorteadas = (int)sorteio.Entre(0, 7);
+                    variantes &= ~(GERADOR_DATA_HIFEN | GERADOR_HORA_DOIS_PONTOS | GERADOR_DECIMAL_PONTO);
+                    variantes |= sorteadas & (GERADOR_DATA_HIFEN | GERADOR_HORA_DOIS_PONTOS | GERADOR_DECIMAL_PONTO);
+                }
+
+                if (pendente)
+                    saida.Escrever(quebra, tamanho_quebra);
+
+                saida.Escrever(datas[(variantes & GERADOR_DATA_HIFEN) ? 1 : 0], 10);
+                saida.Escrever(';');
+                if (variantes & GERADOR_HORA_DOIS_PONTOS)
+                    saida.Escrever(horas_dois_pontos[h], 5);
+                else
+                    saida.Escrever(horas_utc[h], 8);
+                saida.Escrever(';');
+
+                char virgula = (variantes & GERADOR_DECIMAL_PONTO) ? '.' : ',';
+                for (int v = 0; v < GERADOR_VARIAVEIS; v++)
+                {
+                    double fracao = sorteio.Fracao();
+                    if (fracao < opcoes.ausentes)
+                    {
+                        // Metade dos ausentes fica vazia, metade sai como -9999.
+                        if (fracao * 2 >= opcoes.ausentes)
+                            saida.Escrever("-9999", 5);
+                    }
+                    else if (v == 0 && sorteio.Fracao() < GERADOR_CHANCE_SEM_CHUVA)
+                        escreverDecimos(0, virgula, saida);
+                    else
+                        escreverDecimos((int)sorteio.Entre(faixas[v].minimo, faixas[v].maximo), virgula, saida);
+                    saida.Escrever(';');
+                }
+
+                // A quebra só é escrita antes da próxima linha, para podermos omiti-la no fim.
+                pendente = true;
+                escritas++;
+
+                if ((variantes & GERADOR_LINHAS_VAZIAS) && sorteio.Fracao() < GERADOR_CHANCE_LINHA_VAZIA)
+                    saida.Escrever(quebra, tamanho_quebra);
+            }
+        }
+
+        if (pendente && !(opcoes.variantes & GERADOR_SEM_QUEBRA_FINAL))
+            saida.Escrever(quebra, tamanho_quebra);
+
+        ok = saida.Descarregar();
+    }
+
+    if (bytes != nullptr)
+        *bytes = (long long)lseek(descritor, 0, SEEK_CUR);
+    if (linhas != nullptr)
+        *linhas = escritas;
+
+    return close(descritor) == 0 && ok;
+}
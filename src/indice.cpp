@@ -0,0 +1,88 @@
+#include "indice.h"
+
+void IndiceHorario::crescer(long long tamanho)
+{
+    if (largo)
+        posicoes64.resize(tamanho, 0);
+    else
+        posicoes32.resize(tamanho, 0);
+
+    presenca.resize((tamanho + 63) / 64, 0);
+}
+
+bool IndiceHorario::Inserir(const Momento &momento, uint64_t posicao)
+{
+    if (!momento.IsCompleto() || momento.horario.minuto != 0)
+        return false;
+
+    long long horas = momento.GetHoras();
+
+    if (quantidade == 0 && GetTamanho() == 0)
+        base = horas;
+
+    long long hora = horas - base;
+    if (hora < 0)
+        return false;
+
+    if (hora >= GetTamanho())
+    {
+        if (hora - GetTamanho() > INDICE_LACUNA_MAXIMA)
+            return false;
+
+        crescer(hora + 1);
+    }
+
+    // Uma posição além de 32 bits migra todo o índice para 64 bits.
+    if (!largo && posicao > UINT32_MAX)
+    {
+        posicoes64.assign(posicoes32.begin(), posicoes32.end());
+        posicoes32.clear();
+        posicoes32.shrink_to_fit();
+        largo = true;
+    }
+
+    if (largo)
+        posicoes64[hora] = posicao;
+    else
+        posicoes32[hora] = (uint32_t)posicao;
+
+    if (!IsPresente(hora))
+    {
+        presenca[hora >> 6] |= 1ULL << (hora & 63);
+        quantidade++;
+    }
+
+    return true;
+}
+
+bool IndiceHorario::Buscar(const Momento &momento, uint64_t *posicao) const
+{
+    if (!momento.IsCompleto() || momento.horario.minuto != 0)
+        return false;
+
+    long long hora = momento.GetHoras() - base;
+    if (hora < 0 || hora >= GetTamanho() || !IsPresente(hora))
+        return false;
+
+    *posicao = GetPosicao(hora);
+    return true;
+}
+
+bool IndiceHorario::GetIntervalo(const Momento &de, const Momento &ate, long long *primeira, long long *ultima) const
+{
+    // As linhas ficam sempre em hora cheia, então um início quebrado começa na hora seguinte.
+    long long inicio = de.GetHoras() - base + (de.horario.minuto > 0 ? 1 : 0);
+    long long fim = ate.GetHoras() - base;
+
+    if (inicio < 0)
+        inicio = 0;
+    if (fim >= GetTamanho())
+        fim = GetTamanho() - 1;
+
+    if (inicio > fim)
+        return false;
+
+    *primeira = inicio;
+    *ultima = fim;
+    return true;
+}
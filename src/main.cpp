@@ -1,7 +1,19 @@
+#include <consulta.h>
+#include <estatisticas.h>
+#include <protocolo.h>
+#include <rastreio.h>
 #include <serie.h>
+#include <servidor.h>
+#include <tabela.h>
 
+#include <fstream>
 #include <iostream>
+#include <thread>
+#include <vector>
+#include <unistd.h>
 #include <ctype.h>
+#include <signal.h>
+#include <string.h>
 
 #define MODO_INDEFINIDO 0
 #define MODO_ESPECIFICO 1
@@ -24,6 +36,26 @@ Momento secundaria;
 
 Series *series;
 
+// Arquivo e opções da série, para carregá-la de novo se o arquivo for trocado.
+const char *arquivo_series = nullptr;
+int opcoes_series = SERIES_PADRAO;
+
+// Indexa as linhas acrescentadas ao arquivo antes de cada consulta.
+bool seguir = false;
+
+// Servidor em execução no modo --servidor, parado pelos sinais de término.
+Servidor *servidor = nullptr;
+
+// Formato da tabela de resultados (TABELA_*).
+int formato_tabela = TABELA_ALINHADA;
+
+// Estatísticas impressas ao sair: legíveis na saída de erro, e em JSON em um arquivo.
+bool mostrar_estatisticas = false;
+const char *arquivo_estatisticas = nullptr;
+
+// Arquivo onde os trechos rastreados são salvos ao sair, se pedido.
+const char *arquivo_rastreio = nullptr;
+
 // Mostra o cabeçalho do programa.
 void UIShowInformativo();
 
@@ -41,36 +73,183 @@ bool UIGetEscolhas(int *, int);
 // Questiona o usuário por um único número.
 bool UIGetEscolha(int *, bool *);
 
-// Estrutura do cabeçalho da nossa tabela.
-void UIShowTabelaHeader();
-
-// Estrutura do conteúdo da nossa tabela.
-void UIShowTabelaContent(Linha l);
-
-// Estrutura do rodapé da nossa tabela.
-void UIShowTabelaFooter(long itens, double *somas, double *maiores, double *menores);
-
 // Pausa a execução e espera que o usuário pressione Enter.
 void UIGetEnterParaContinuar();
 
 // Faz a leitura somente de digitos da entrada do usuário
 int UIEntrada(int *v);
 
+// Escreve as estatísticas pedidas na linha de comando. Chamada ao sair do programa.
+void EscreverEstatisticas();
+
+// Salva os trechos rastreados. Chamada ao sair do programa.
+void EscreverRastreio();
+
+// Com --seguir, indexa as linhas novas do arquivo. Se ele ficou menor do que
+// o já indexado (truncado ou trocado), a série é carregada de novo.
+void SeguirArquivo();
+
+// Executa as consultas de um arquivo (ou da entrada padrão, com "-") e escreve
+// os resultados na saída padrão. Retorna o código de saída do programa.
+int ExecutarLote(const char *arquivo, int formato);
+
+// Carrega as séries dos arquivos e responde as consultas recebidas no socket
+// até receber SIGINT ou SIGTERM. Retorna o código de saída do programa.
+int ExecutarServidor(const char *socket, const std::vector<const char *> &arquivos, int opcoes, int threads);
+
+// Envia ao servidor as consultas de um arquivo (ou da entrada padrão, com "-")
+// e escreve as respostas na saída padrão, como o modo --batch.
+int ExecutarCliente(const char *socket, const char *arquivo, int estacao, int formato);
+
 // Função de entrada do programa.
 int main(int argc, char *argv[])
 {
     // 1- O nosso programa.
-    // 2- O arquivo que queremos carregar.
-    if(argc < 2 || argc > 2) {
+    // 2- O arquivo que queremos carregar, e opções em qualquer posição.
+    const char *arquivo = nullptr;
+    const char *lote = nullptr;
+    const char *socket_servidor = nullptr;
+    const char *socket_cliente = nullptr;
+    std::vector<const char *> arquivos;
+    int opcoes = SERIES_PADRAO;
+    int formato = FORMATO_CSV;
+    int estacao = 0;
+    int threads = (int)std::thread::hardware_concurrency();
+    bool entrada_valida = true;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--indice-compacto") == 0)
+            opcoes |= SERIES_INDICE_COMPACTO;
+        else if (strcmp(argv[i], "--mapear") == 0)
+            opcoes |= SERIES_MAPEAR;
+        else if (strcmp(argv[i], "--paralelo") == 0)
+            opcoes |= SERIES_PARALELO;
+        else if (strcmp(argv[i], "--indice-persistente") == 0)
+            opcoes |= SERIES_INDICE_PERSISTENTE;
+        else if (strcmp(argv[i], "--carregar-tudo") == 0)
+            opcoes |= SERIES_CARREGAR_TUDO;
+        else if (strcmp(argv[i], "--piramide") == 0)
+            opcoes |= SERIES_PIRAMIDE;
+        else if (strcmp(argv[i], "--indice-sazonal") == 0)
+            opcoes |= SERIES_INDICE_SAZONAL;
+        else if (strcmp(argv[i], "--tabela") == 0 && i + 1 < argc)
+        {
+            i++;
+            if (strcmp(argv[i], "alinhada") == 0)
+                formato_tabela = TABELA_ALINHADA;
+            else if (strcmp(argv[i], "csv") == 0)
+                formato_tabela = TABELA_CSV;
+            else if (strcmp(argv[i], "tsv") == 0)
+                formato_tabela = TABELA_TSV;
+            else
+                entrada_valida = false;
+        }
+        else if (strcmp(argv[i], "--stats") == 0)
+            mostrar_estatisticas = true;
+        else if (strcmp(argv[i], "--stats-json") == 0 && i + 1 < argc)
+            arquivo_estatisticas = argv[++i];
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+            arquivo_rastreio = argv[++i];
+        else if (strcmp(argv[i], "--seguir") == 0)
+            seguir = true;
+        else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc)
+            lote = argv[++i];
+        else if (strcmp(argv[i], "--formato") == 0 && i + 1 < argc)
+        {
+            i++;
+            if (strcmp(argv[i], "csv") == 0)
+                formato = FORMATO_CSV;
+            else if (strcmp(argv[i], "json") == 0)
+                formato = FORMATO_JSON;
+            else
+                entrada_valida = false;
+        }
+        else if (strcmp(argv[i], "--servidor") == 0 && i + 1 < argc)
+            socket_servidor = argv[++i];
+        else if (strcmp(argv[i], "--cliente") == 0 && i + 1 < argc)
+            socket_cliente = argv[++i];
+        else if (strcmp(argv[i], "--estacao") == 0 && i + 1 < argc)
+            estacao = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else if (argv[i][0] != '-')
+            arquivos.push_back(argv[i]);
+        else
+            entrada_valida = false;
+    }
+
+    // O servidor atende vários arquivos; o cliente não carrega nenhum; os outros modos, um só.
+    if (socket_servidor != nullptr && socket_cliente != nullptr)
+        entrada_valida = false;
+    else if (socket_servidor != nullptr)
+        entrada_valida = entrada_valida && !arquivos.empty() && arquivos.size() <= UINT16_MAX + 1 && lote == nullptr;
+    else if (socket_cliente != nullptr)
+        entrada_valida = entrada_valida && arquivos.empty() && estacao >= 0 && estacao <= UINT16_MAX;
+    else if (arquivos.size() == 1)
+        arquivo = arquivos[0];
+    else
+        entrada_valida = false;
+
+    if(!entrada_valida || (arquivo == nullptr && socket_servidor == nullptr && socket_cliente == nullptr)) {
         printf("\nInforme corretamente a entrada para o programa.\n");
         printf("Exemplo de entrada: \n");
         printf("\t$ ./programa \"diretorio/do/arquivo/INMET.CSV\"\n");
+        printf("Opções:\n");
+        printf("\t--indice-compacto  Indexa por hora em um vetor compacto no lugar da árvore.\n");
+        printf("\t--mapear           Mapeia o arquivo em memória para ler as linhas.\n");
+        printf("\t--paralelo         Indexa o arquivo usando todos os núcleos.\n");
+        printf("\t--indice-persistente\n");
+        printf("\t                   Salva o índice em \"arquivo.idx\" e o reaproveita enquanto o arquivo não mudar.\n");
+        printf("\t--carregar-tudo    Decodifica o arquivo inteiro para a memória uma única vez.\n");
+        printf("\t--piramide         Pré-calcula resumos por dia, mês e ano para intervalos longos.\n");
+        printf("\t--indice-sazonal   Indexa também por mês e hora, para consultas com campos em branco.\n");
+        printf("\t--tabela alinhada|csv|tsv\n");
+        printf("\t                   Formato da tabela de resultados do menu (padrão: alinhada).\n");
+        printf("\t--stats           Mostra, ao sair, contadores e tempos da carga e das consultas.\n");
+        printf("\t--stats-json <arquivo>\n");
+        printf("\t                   Salva, ao sair, as mesmas estatísticas em JSON (\"-\" para a saída de erro).\n");
+        printf("\t--trace <arquivo> Salva, ao sair, os trechos de carga e consulta para o Perfetto (JSON).\n");
+        printf("\t--seguir          Antes de cada consulta, indexa as linhas acrescentadas ao arquivo.\n");
+        printf("\t--batch <arquivo>  Executa as consultas do arquivo (\"-\" para a entrada padrão), sem menu.\n");
+        printf("\t                   Uma por linha: \"linha <m>\", \"linhas <de> [ate]\" ou \"resumo <de> [ate]\",\n");
+        printf("\t                   com momentos como 2024-03-01T12:00, 2024-03 ou *-07-*T15.\n");
+        printf("\t--formato csv|json Formato da saída do modo --batch (padrão: csv).\n");
+        printf("\t--servidor <socket> arquivo.csv [arquivo.csv ...]\n");
+        printf("\t                   Carrega os arquivos uma vez e responde consultas no socket Unix.\n");
+        printf("\t--threads N        Pedidos atendidos ao mesmo tempo pelo servidor (padrão: núcleos).\n");
+        printf("\t--cliente <socket> Envia ao servidor as consultas de --batch (padrão: entrada padrão).\n");
+        printf("\t--estacao N        Arquivo consultado pelo cliente, na ordem do servidor (padrão: 0).\n");
         printf("Saindo do programa.\n\n");
 
         return -1;
     } 
 
-    series = new Series(argv[1]);
+    if (mostrar_estatisticas || arquivo_estatisticas != nullptr)
+        atexit(EscreverEstatisticas);
+
+    if (arquivo_rastreio != nullptr)
+    {
+        RastreioAtivar();
+        atexit(EscreverRastreio);
+    }
+
+    if (socket_cliente != nullptr)
+        return ExecutarCliente(socket_cliente, lote != nullptr ? lote : "-", estacao, formato);
+
+    if (socket_servidor != nullptr)
+        return ExecutarServidor(socket_servidor, arquivos, opcoes, threads);
+
+    arquivo_series = arquivo;
+    opcoes_series = opcoes;
+    series = new Series(arquivo, opcoes);
+
+    if (lote != nullptr)
+    {
+        int status = ExecutarLote(lote, formato);
+        delete series;
+        return status;
+    }
 
     while (exit_program == false)
     {
@@ -81,6 +260,9 @@ int main(int argc, char *argv[])
         if (!UIShowConsulta() || !UIShowQuestionario())
             continue;
 
+        if (seguir)
+            SeguirArquivo();
+
         UIShowResultado();
     }
 
@@ -88,6 +270,206 @@ int main(int argc, char *argv[])
     return 0;
 }
 
+void EscreverEstatisticas()
+{
+    if (mostrar_estatisticas)
+        EstatisticasImprimir(stderr);
+
+    if (arquivo_estatisticas == nullptr)
+        return;
+
+    if (strcmp(arquivo_estatisticas, "-") == 0)
+    {
+        EstatisticasImprimirJson(stderr);
+        return;
+    }
+
+    FILE *saida = fopen(arquivo_estatisticas, "w");
+    if (saida == nullptr)
+    {
+        fprintf(stderr, "Não foi possível salvar as estatísticas em %s.\n", arquivo_estatisticas);
+        return;
+    }
+    EstatisticasImprimirJson(saida);
+    fclose(saida);
+}
+
+void EscreverRastreio()
+{
+    if (!RastreioSalvar(arquivo_rastreio))
+        fprintf(stderr, "Não foi possível salvar o rastreio em %s.\n", arquivo_rastreio);
+}
+
+void SeguirArquivo()
+{
+    if (series->Atualizar())
+        return;
+
+    delete series;
+    series = new Series(arquivo_series, opcoes_series);
+}
+
+int ExecutarLote(const char *arquivo, int formato)
+{
+    std::ifstream fluxo;
+    std::istream *entrada = &std::cin;
+
+    if (strcmp(arquivo, "-") != 0)
+    {
+        fluxo.open(arquivo);
+        if (!fluxo.is_open())
+        {
+            std::cerr << "Não foi possível abrir o arquivo de consultas: " << arquivo << std::endl;
+            return 1;
+        }
+        entrada = &fluxo;
+    }
+
+    Saida saida(STDOUT_FILENO);
+    std::string texto;
+    long long numero = 0;
+    bool erros = false;
+
+    // Cada consulta é identificada pelo número da sua linha no arquivo.
+    while (std::getline(*entrada, texto))
+    {
+        numero++;
+
+        Consulta consulta;
+        const char *erro;
+        if (!AnalisarConsulta(texto.data(), texto.data() + texto.size(), &consulta, &erro))
+        {
+            if (erro != nullptr)
+            {
+                EscreverErro(numero, erro, formato, saida);
+                erros = true;
+            }
+            continue;
+        }
+
+        if (seguir)
+            SeguirArquivo();
+
+        ExecutarConsulta(*series, consulta, numero, formato, saida);
+
+        // Seguindo o arquivo, cada resposta sai assim que fica pronta.
+        if (seguir)
+            saida.Descarregar();
+    }
+
+    if (!saida.Descarregar())
+        return 1;
+
+    return erros ? 2 : 0;
+}
+
+// Tratador de SIGINT e SIGTERM do modo --servidor.
+static void pararServidor(int)
+{
+    if (servidor != nullptr)
+        servidor->Parar();
+}
+
+int ExecutarServidor(const char *socket, const std::vector<const char *> &arquivos, int opcoes, int threads)
+{
+    std::vector<Series *> estacoes;
+    for (const char *arquivo : arquivos)
+        estacoes.push_back(new Series(arquivo, opcoes));
+
+    Servidor instancia(socket, estacoes, threads);
+    int status = 0;
+
+    if (instancia.Abrir())
+    {
+        fprintf(stderr, "Servindo %zu arquivo(s) em %s com %d thread(s):\n", arquivos.size(), socket,
+                threads > 0 ? threads : 1);
+        for (size_t e = 0; e < arquivos.size(); e++)
+            fprintf(stderr, "\t--estacao %zu: %s\n", e, arquivos[e]);
+
+        // Sem SA_RESTART: o accept bloqueado precisa voltar quando o sinal chega.
+        struct sigaction acao = {};
+        acao.sa_handler = pararServidor;
+        sigemptyset(&acao.sa_mask);
+        servidor = &instancia;
+        sigaction(SIGINT, &acao, nullptr);
+        sigaction(SIGTERM, &acao, nullptr);
+
+        instancia.Servir();
+        servidor = nullptr;
+    }
+    else
+    {
+        fprintf(stderr, "Não foi possível escutar em %s (caminho inválido ou servidor já em execução).\n", socket);
+        status = 1;
+    }
+
+    for (Series *estacao : estacoes)
+        delete estacao;
+    return status;
+}
+
+int ExecutarCliente(const char *socket, const char *arquivo, int estacao, int formato)
+{
+    std::ifstream fluxo;
+    std::istream *entrada = &std::cin;
+
+    if (strcmp(arquivo, "-") != 0)
+    {
+        fluxo.open(arquivo);
+        if (!fluxo.is_open())
+        {
+            std::cerr << "Não foi possível abrir o arquivo de consultas: " << arquivo << std::endl;
+            return 1;
+        }
+        entrada = &fluxo;
+    }
+
+    int conexao = ConectarServidor(socket);
+    if (conexao < 0)
+    {
+        std::cerr << "Não foi possível conectar ao servidor em " << socket << std::endl;
+        return 1;
+    }
+
+    Saida saida(STDOUT_FILENO);
+    CabecalhoResposta cabecalho;
+    std::string texto, resposta;
+    long long numero = 0;
+    bool erros = false, perdida = false;
+
+    while (std::getline(*entrada, texto))
+    {
+        numero++;
+
+        if (!EnviarPedido(conexao, (uint32_t)numero, (uint16_t)estacao, (uint8_t)formato, texto.data(), texto.size()) ||
+            !ReceberResposta(conexao, &cabecalho, resposta))
+        {
+            perdida = true;
+            break;
+        }
+
+        saida.Escrever(resposta.data(), resposta.size());
+        erros = erros || cabecalho.estado != PROTOCOLO_OK;
+
+        // Consultas digitadas têm a resposta assim que ela chega.
+        if (entrada == &std::cin)
+            saida.Descarregar();
+    }
+
+    close(conexao);
+
+    if (!saida.Descarregar())
+        return 1;
+
+    if (perdida)
+    {
+        std::cerr << "A conexão com o servidor foi perdida na consulta " << numero << std::endl;
+        return 1;
+    }
+
+    return erros ? 2 : 0;
+}
+
 void UIShowInformativo()
 {
     system("clear");
@@ -170,62 +552,52 @@ bool UIShowQuestionario()
 
 void UIShowResultado()
 {
-    int j;
-    double d;
-
-    double *soma = (double *)calloc(sizeof(double), 17);
-    double *maior = (double *)calloc(sizeof(double), 17);
-    double *menor = (double *)calloc(sizeof(double), 17);
-
-    Lista<Linha> linhas;
-    Linha l;
+    Agregado agregados[QUANTIDADE_VARIAVEIS];
 
     UIShowInformativo();
 
     if (modo == MODO_ESPECIFICO)
         secundaria = primaria;
 
-    if (!series->GetLinhas(primaria, secundaria, &linhas))
+    // A tabela é escrita direto no descritor da saída padrão, em blocos grandes;
+    // o que o printf ainda tiver no buffer precisa sair antes.
+    fflush(stdout);
+
+    RASTREAR("UIShowResultado");
+
+    Saida saida(STDOUT_FILENO);
+    Tabela tabela(saida, formato_tabela);
+
+    // Uma única passada: cada linha é impressa e entra no resumo do rodapé. O
+    // cabeçalho só sai com a primeira linha, para um intervalo vazio não deixar
+    // uma tabela sem corpo.
+    AgregadorLinhas agregador(VARIAVEIS_TODAS, agregados);
+    bool cabecalho = false;
+    bool encontrado = series->ParaCada(primaria, secundaria, [&](const Linha &linha) -> bool
+                                       {
+                                           if (!cabecalho)
+                                           {
+                                               tabela.EscreverCabecalho();
+                                               cabecalho = true;
+                                           }
+                                           tabela.EscreverLinha(linha);
+                                           agregador.Adicionar(linha);
+                                           return true;
+                                       });
+    agregador.Concluir();
+
+    if (!encontrado)
     {
+        saida.Descarregar();
         std::cerr << "Erro ao listar todos os itens, verifique se seu arquivo.csv é suportado." << std::endl;
         exit_program = true;
         UIGetEnterParaContinuar();
         return;
     }
 
-    UIShowTabelaHeader();
-    for (auto i = linhas.GetInicio(); i != nullptr; i = i->proximo)
-    {
-        l = i->valor;
-
-        double variaveis[17] = {l.precipitacao_total, l.pressao_atmosferica, l.pressao_atmosferica_max,
-                                l.pressao_atmosferica_min, l.radiacao_global, l.temperatura_ar,
-                                l.temperatura_orvalho, l.temperatura_ar_max, l.temperatura_ar_min,
-                                l.temperatura_orvalho_max, l.temperatura_orvalho_min, l.umidade_relativa_max,
-                                l.umidade_relativa_min, l.umidade_relativa, l.vento_direcao,
-                                l.vento_rajada, l.vento_velocidade};
-
-        for (j = 0; j < 17; j++)
-        {
-            d = variaveis[j];
-
-            soma[j] += d;
-
-            if(d <= 0)
-                continue;
-
-            if (d > maior[j])
-                maior[j] = d;
-
-            if (menor[j] == 0 || d < menor[j])
-                menor[j] = d;
-        
-        }
-
-        UIShowTabelaContent(i->valor);
-    }
+    tabela.EscreverRodape(agregados);
+    saida.Descarregar();
 
-    UIShowTabelaFooter(linhas.GetTamanho(), soma, maior, menor);
     UIGetEnterParaContinuar();
 }
 
@@ -269,12 +641,20 @@ bool UIGetData(Momento *momento)
             return false;
         }
 
+    // Com o mês informado, o dia precisa existir nele; sem o ano, 29 de fevereiro vale.
+    if (!ignorado && mes != MOMENTO_DONT_COMPARE &&
+        dia > DiasNoMes(mes, ano != MOMENTO_DONT_COMPARE ? ano : 2000))
+    {
+        std::cerr << "\nO dia " << dia << " não existe nesse mês\n";
+        return false;
+    }
+
     printf(" - Hora [Ex: 23]: ");
     if (!UIGetEscolha(&hora, &ignorado))
         return false;
 
     if (!ignorado)
-        if (hora < 0 || dia > 23)
+        if (hora < 0 || hora > 23)
         {
             std::cerr << "\nInforme uma hora dentro de 0 e 23\n";
             return false;
@@ -285,9 +665,9 @@ bool UIGetData(Momento *momento)
         return false;
 
     if (!ignorado)
-        if (hora < 0 || dia > 23)
+        if (minuto < 0 || minuto > 59)
         {
-            std::cerr << "\nInforme um minuto dentro de 0 e 23\n";
+            std::cerr << "\nInforme um minuto dentro de 0 e 59\n";
             return false;
         }
 
@@ -408,115 +788,6 @@ int UIEntrada(int *v)
     return STATUS_ERRO;
 }
 
-void UIShowTabelaHeader()
-{
-    printf("%-4s|%-4s|%-6s|", "Dia", "Mes", "Ano");
-    printf("%-5s|%-5s|", "Hora", "Min");
-
-    printf("%-13s|", "Precipitacao");
-    printf("%-16s|", "Radiacao Global");
-    printf("%-12s|", "Pressao");
-    printf("%-16s|", "Pressao Max");
-    printf("%-16s|", "Pressao Min");
-    printf("%-12s|", "Temp. Ar");
-    printf("%-14s|", "Temp. Ar Max");
-    printf("%-14s|", "Temp. Ar Min");
-    printf("%-14s|", "Temp. Orvalho");
-    printf("%-14s|", "Temp. Or. Max");
-    printf("%-14s|", "Temp. Or. Min");
-    printf("%-10s|", "Umidade");
-    printf("%-13s|", "Umidade Max");
-    printf("%-13s|", "Umidade Min");
-    printf("%-14s|", "Vento Direcao");
-    printf("%-11s|", "Vento Vel.");
-    printf("%-12s|", "Vento Rajada");
-    printf("\n");
-
-    printf("%-4s|", "dd");
-    printf("%-4s|", "mm");
-    printf("%-6s|", "aaaa");
-    printf("%-5s|", "hh");
-    printf("%-5s|", "MM");
-    printf("%-13s|", "(mm)");
-    printf("%-16s|", "(Kj/m^2)");
-    printf("%-12s|", "(mB)");
-    printf("%-16s|", "(mB)");
-    printf("%-16s|", "(mB)");
-    printf("%-12s|", "(oC)");
-    printf("%-14s|", "(oC)");
-    printf("%-14s|", "(oC)");
-    printf("%-14s|", "(oC)");
-    printf("%-14s|", "(oC)");
-    printf("%-14s|", "(oC)");
-    printf("%-10s|", "(%)");
-    printf("%-13s|", "(%)");
-    printf("%-13s|", "(%)");
-    printf("%-14s|", "(ogr)");
-    printf("%-11s|", "(m/s)");
-    printf("%-12s|", "(m/s)");
-    printf("\n");
-
-     for(int i = 1; i <= 274; i++)
-        printf("-");
-
-    printf("\n");
-}
-
-void UIShowTabelaContent(Linha l)
-{
-    printf("%-4d|%-4d|%-6d|%-5d|%-5d|%-13.2f|%-16.2f|%-12.2f|%-16.2f|%-16.2f|%-12.2f|%-14.2f|%-14.2f|%-14.2f|%-14.2f|%-14.2f|%-10.2f|%-13.2f|%-13.2f|%-14.2f|%-11.2f|%-12.2f|\n",
-           l.momento.data.dia,
-           l.momento.data.mes,
-           l.momento.data.ano,
-           l.momento.horario.hora,
-           l.momento.horario.minuto,
-           l.precipitacao_total,
-           l.radiacao_global,
-           l.pressao_atmosferica,
-           l.pressao_atmosferica_max,
-           l.pressao_atmosferica_min,
-           l.temperatura_ar,
-           l.temperatura_ar_max,
-           l.temperatura_ar_min,
-           l.temperatura_orvalho,
-           l.temperatura_orvalho_max,
-           l.temperatura_orvalho_min,
-           l.umidade_relativa,
-           l.umidade_relativa_max,
-           l.umidade_relativa_min,
-           l.vento_direcao,
-           l.vento_velocidade,
-           l.vento_rajada);
-}
-
-void UIShowTabelaFooter(long itens, double *somas, double *maiores, double *menores)
-{
-    double *medias = (double *)calloc(sizeof(double), 17);
-    
-    for(int i = 1; i <= 274; i++)
-        printf("-");
-
-    printf("\n");
-    for (int i = 0; i < 17; i++)
-        medias[i] = somas[i] / itens;
-    
-    printf("%28s|%-13.2f|%-16.2f|%-12.2f|%-16.2f|%-16.2f|%-12.2f|%-14.2f|%-14.2f|%-14.2f|%-14.2f|%-14.2f|%-10.2f|%-13.2f|%-13.2f|%-14.2f|%-11.2f|%-12.2f|\n",
-           "Medias: ", medias[0], medias[1], medias[2], medias[3], medias[4], medias[5], medias[6], medias[7],
-           medias[8], medias[9], medias[10], medias[11], medias[12], medias[13], medias[14], medias[15], medias[16]);
-
-     printf("%28s|%-13.2f|%-16.2f|%-12.2f|%-16.2f|%-16.2f|%-12.2f|%-14.2f|%-14.2f|%-14.2f|%-14.2f|%-14.2f|%-10.2f|%-13.2f|%-13.2f|%-14.2f|%-11.2f|%-12.2f|\n",
-           "Soma total:", somas[0], somas[1], somas[2], somas[3], somas[4], somas[5], somas[6], somas[7],
-           somas[8], somas[9], somas[10], somas[11], somas[12], somas[13], somas[14], somas[15], somas[16]);
-
-     printf("%28s|%-13.2f|%-16.2f|%-12.2f|%-16.2f|%-16.2f|%-12.2f|%-14.2f|%-14.2f|%-14.2f|%-14.2f|%-14.2f|%-10.2f|%-13.2f|%-13.2f|%-14.2f|%-11.2f|%-12.2f|\n",
-           "Maiores valores:", maiores[0], maiores[1], maiores[2], maiores[3], maiores[4], maiores[5], maiores[6], maiores[7],
-           maiores[8], maiores[9], maiores[10], maiores[11], maiores[12], maiores[13], maiores[14], maiores[15], maiores[16]);
-
-     printf("%28s|%-13.2f|%-16.2f|%-12.2f|%-16.2f|%-16.2f|%-12.2f|%-14.2f|%-14.2f|%-14.2f|%-14.2f|%-14.2f|%-10.2f|%-13.2f|%-13.2f|%-14.2f|%-11.2f|%-12.2f|\n",
-           "Menores valores:", menores[0], menores[1], menores[2], menores[3], menores[4], menores[5], menores[6], menores[7],
-           menores[8], menores[9], menores[10], menores[11], menores[12], menores[13], menores[14], menores[15], menores[16]);
-}
-
 // Pausa a execução e espera que o usuário pressione Enter.
 void UIGetEnterParaContinuar()
 {
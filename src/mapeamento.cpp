@@ -0,0 +1,57 @@
+#include "mapeamento.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+bool Mapeamento::Abrir(const char *arquivo)
+{
+    Fechar();
+
+    int fd = open(arquivo, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    void *endereco = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (endereco == MAP_FAILED)
+    {
+        close(fd);
+        return false;
+    }
+
+    this->dados = (const char *)endereco;
+    this->tamanho = (size_t)info.st_size;
+    this->descritor = fd;
+    return true;
+}
+
+bool Mapeamento::Conferir() const
+{
+    struct stat info;
+    return dados != nullptr && fstat(descritor, &info) == 0 && (size_t)info.st_size >= tamanho;
+}
+
+void Mapeamento::Fechar()
+{
+    if (dados != nullptr)
+        munmap((void *)dados, tamanho);
+    if (descritor >= 0)
+        close(descritor);
+
+    dados = nullptr;
+    tamanho = 0;
+    descritor = -1;
+}
+
+Mapeamento::~Mapeamento()
+{
+    Fechar();
+}
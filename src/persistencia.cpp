@@ -0,0 +1,182 @@
+#include "persistencia.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Identificação do formato, no início do arquivo de índice.
+static const char ASSINATURA_FORMATO[8] = {'S', 'E', 'R', 'I', 'E', 'I', 'D', 'X'};
+
+/*
+ * Cabeçalho fixo do arquivo de índice. Em seguida vêm as chaves e valores do
+ * cabeçalho do CSV, e então os registros, alinhados em 8 bytes.
+ */
+typedef struct CabecalhoIndice
+{
+    char formato[8];
+    uint32_t versao;
+    uint32_t itens_cabecalho;
+    AssinaturaArquivo assinatura;
+    uint64_t quantidade;
+} CabecalhoIndice;
+
+static uint64_t fnv1a(uint64_t soma, const char *dados, size_t tamanho)
+{
+    for (size_t i = 0; i < tamanho; i++)
+    {
+        soma ^= (unsigned char)dados[i];
+        soma *= 1099511628211ULL;
+    }
+    return soma;
+}
+
+bool GetAssinatura(const char *caminho, AssinaturaArquivo *assinatura)
+{
+    struct stat info;
+    if (stat(caminho, &info) != 0)
+        return false;
+
+    std::ifstream arquivo(caminho, std::ios::binary);
+    if (!arquivo.is_open())
+        return false;
+
+    assinatura->tamanho = (uint64_t)info.st_size;
+    assinatura->modificacao = (int64_t)info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec;
+    assinatura->mudanca = (int64_t)info.st_ctim.tv_sec * 1000000000LL + info.st_ctim.tv_nsec;
+    assinatura->inode = (uint64_t)info.st_ino;
+
+    // Os metadados pegam as mudanças feitas por escrita; as janelas, cópias que os
+    // preservam com o conteúdo trocado no início ou no fim.
+    std::vector<char> janela(PERSISTENCIA_JANELA);
+    uint64_t soma = 14695981039346656037ULL;
+
+    arquivo.read(janela.data(), janela.size());
+    soma = fnv1a(soma, janela.data(), (size_t)arquivo.gcount());
+
+    if (assinatura->tamanho > PERSISTENCIA_JANELA)
+    {
+        arquivo.clear();
+        arquivo.seekg((std::streamoff)(assinatura->tamanho - PERSISTENCIA_JANELA));
+        arquivo.read(janela.data(), janela.size());
+        soma = fnv1a(soma, janela.data(), (size_t)arquivo.gcount());
+    }
+
+    assinatura->soma = soma;
+    return true;
+}
+
+static void escreverTexto(FILE *saida, const std::string &texto)
+{
+    uint32_t tamanho = (uint32_t)texto.size();
+    fwrite(&tamanho, sizeof(tamanho), 1, saida);
+    fwrite(texto.data(), 1, tamanho, saida);
+}
+
+bool SalvarIndice(const char *caminho, const AssinaturaArquivo &assinatura,
+                  const CabecalhoPersistido &cabecalho, const std::vector<RegistroIndice> &registros)
+{
+    // Um nome único no mesmo diretório: processos que salvam o mesmo índice ao
+    // mesmo tempo não escrevem no mesmo temporário, e o rename continua atômico.
+    std::string temporario = std::string(caminho) + ".XXXXXX";
+    int descritor = mkstemp(&temporario[0]);
+    if (descritor < 0)
+        return false;
+
+    // mkstemp cria o arquivo só para o dono; o índice serve a quem puder ler o CSV.
+    fchmod(descritor, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+    FILE *saida = fdopen(descritor, "wb");
+    if (saida == nullptr)
+    {
+        close(descritor);
+        remove(temporario.c_str());
+        return false;
+    }
+
+    CabecalhoIndice topo;
+    memcpy(topo.formato, ASSINATURA_FORMATO, sizeof(topo.formato));
+    topo.versao = PERSISTENCIA_VERSAO;
+    topo.itens_cabecalho = (uint32_t)cabecalho.size();
+    topo.assinatura = assinatura;
+    topo.quantidade = registros.size();
+
+    fwrite(&topo, sizeof(topo), 1, saida);
+    for (auto &item : cabecalho)
+    {
+        escreverTexto(saida, item.first);
+        escreverTexto(saida, item.second);
+    }
+
+    // Alinhamos os registros para que possam ser lidos direto do mapeamento.
+    static const char zeros[8] = {0};
+    size_t escrito = (size_t)ftell(saida);
+    fwrite(zeros, 1, (8 - escrito % 8) % 8, saida);
+
+    fwrite(registros.data(), sizeof(RegistroIndice), registros.size(), saida);
+
+    bool falhou = ferror(saida) != 0;
+    if (fclose(saida) != 0 || falhou || rename(temporario.c_str(), caminho) != 0)
+    {
+        remove(temporario.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool LeitorIndice::Abrir(const char *caminho, const AssinaturaArquivo &assinatura)
+{
+    cabecalho.clear();
+    registros = nullptr;
+    quantidade = 0;
+
+    if (!mapa.Abrir(caminho) || mapa.GetTamanho() < sizeof(CabecalhoIndice))
+        return false;
+
+    const char *p = mapa.GetDados();
+    const char *fim = p + mapa.GetTamanho();
+
+    CabecalhoIndice topo;
+    memcpy(&topo, p, sizeof(topo));
+    p += sizeof(topo);
+
+    if (memcmp(topo.formato, ASSINATURA_FORMATO, sizeof(topo.formato)) != 0 ||
+        topo.versao != PERSISTENCIA_VERSAO ||
+        topo.assinatura.tamanho != assinatura.tamanho ||
+        topo.assinatura.modificacao != assinatura.modificacao ||
+        topo.assinatura.mudanca != assinatura.mudanca ||
+        topo.assinatura.inode != assinatura.inode ||
+        topo.assinatura.soma != assinatura.soma)
+        return false;
+
+    for (uint32_t i = 0; i < topo.itens_cabecalho * 2; i++)
+    {
+        uint32_t tamanho;
+        if (fim - p < (long)sizeof(tamanho))
+            return false;
+
+        memcpy(&tamanho, p, sizeof(tamanho));
+        p += sizeof(tamanho);
+        if ((uint64_t)(fim - p) < tamanho)
+            return false;
+
+        if (i % 2 == 0)
+            cabecalho.emplace_back(std::string(p, tamanho), std::string());
+        else
+            cabecalho.back().second.assign(p, tamanho);
+        p += tamanho;
+    }
+
+    size_t lido = p - mapa.GetDados();
+    p += (8 - lido % 8) % 8;
+
+    if (p > fim || (uint64_t)(fim - p) != topo.quantidade * sizeof(RegistroIndice))
+        return false;
+
+    registros = (const RegistroIndice *)p;
+    quantidade = topo.quantidade;
+    return true;
+}
@@ -0,0 +1,142 @@
+#include "piramide.h"
+
+#include <algorithm>
+
+#include <rastreio.h>
+
+long long Piramide::chave(const Momento &momento, int nivel)
+{
+    switch (nivel)
+    {
+    case PIRAMIDE_DIA:
+        return DiasDesdeEpoca(momento.data.dia, momento.data.mes, momento.data.ano);
+    case PIRAMIDE_MES:
+        return (long long)momento.data.ano * 12 + momento.data.mes - 1;
+    default:
+        return momento.data.ano;
+    }
+}
+
+void Piramide::Adicionar(const Momento &momento, const double *valores)
+{
+    for (int nivel = 0; nivel < PIRAMIDE_NIVEIS; nivel++)
+    {
+        std::vector<Balde> &baldes = niveis[nivel];
+        long long c = chave(momento, nivel);
+
+        if (baldes.empty() || baldes.back().chave != c)
+        {
+            baldes.emplace_back();
+            baldes.back().chave = c;
+        }
+
+        Balde &balde = baldes.back();
+        for (int i = 0; i < QUANTIDADE_VARIAVEIS; i++)
+            balde.agregados[i].Adicionar(valores[i]);
+    }
+}
+
+void Piramide::RemoverUltimoDia()
+{
+    if (IsVazia())
+        return;
+
+    niveis[PIRAMIDE_DIA].pop_back();
+
+    for (int nivel = PIRAMIDE_MES; nivel < PIRAMIDE_NIVEIS; nivel++)
+    {
+        std::vector<Balde> &baldes = niveis[nivel];
+        const std::vector<Balde> &finos = niveis[nivel - 1];
+
+        Balde refeito;
+        refeito.chave = baldes.back().chave;
+
+        // Os baldes finos do mesmo mês (ou ano) são os últimos do nível de baixo.
+        bool vazio = true;
+        for (auto fino = finos.rbegin(); fino != finos.rend(); ++fino)
+        {
+            long long acima = nivel == PIRAMIDE_MES ? chave(Momento(DataDeDias(fino->chave), Horario(0, 0)), PIRAMIDE_MES)
+                                                    : fino->chave / 12;
+            if (acima != refeito.chave)
+                break;
+
+            for (int i = 0; i < QUANTIDADE_VARIAVEIS; i++)
+                refeito.agregados[i].Combinar(fino->agregados[i]);
+            vazio = false;
+        }
+
+        if (vazio)
+            baldes.pop_back();
+        else
+            baldes.back() = refeito;
+    }
+}
+
+void Piramide::Limpar()
+{
+    for (std::vector<Balde> &baldes : niveis)
+    {
+        baldes.clear();
+        baldes.shrink_to_fit();
+    }
+}
+
+bool Piramide::somar(int nivel, long long de, long long ate, unsigned variaveis, Agregado *agregados) const
+{
+    const std::vector<Balde> &baldes = niveis[nivel];
+
+    auto i = std::lower_bound(baldes.begin(), baldes.end(), de,
+                              [](const Balde &balde, long long c) { return balde.chave < c; });
+
+    bool encontrado = false;
+    for (; i != baldes.end() && i->chave <= ate; ++i)
+    {
+        for (int v = 0; v < QUANTIDADE_VARIAVEIS; v++)
+        {
+            if (variaveis & (1u << v))
+                agregados[v].Combinar(i->agregados[v]);
+        }
+        encontrado = true;
+    }
+
+    return encontrado;
+}
+
+bool Piramide::Agregar(long long primeiro_dia, long long ultimo_dia, unsigned variaveis, Agregado *agregados) const
+{
+    RASTREAR("Piramide::Agregar");
+
+    if (primeiro_dia > ultimo_dia || IsVazia())
+        return false;
+
+    Data inicio = DataDeDias(primeiro_dia);
+    Data fim = DataDeDias(ultimo_dia);
+
+    // Meses inteiramente dentro do intervalo.
+    long long primeiro_mes = (long long)inicio.ano * 12 + inicio.mes - 1 + (inicio.dia > 1 ? 1 : 0);
+    long long ultimo_mes = (long long)fim.ano * 12 + fim.mes - 1 - (fim.dia < DiasNoMes(fim.mes, fim.ano) ? 1 : 0);
+
+    if (primeiro_mes > ultimo_mes)
+        return somar(PIRAMIDE_DIA, primeiro_dia, ultimo_dia, variaveis, agregados);
+
+    // Dias das pontas, fora dos meses inteiros.
+    bool encontrado = false;
+    long long dia_do_primeiro_mes = DiasDesdeEpoca(1, (int)(primeiro_mes % 12) + 1, (int)(primeiro_mes / 12));
+    long long dia_apos_ultimo_mes = DiasDesdeEpoca(1, (int)((ultimo_mes + 1) % 12) + 1, (int)((ultimo_mes + 1) / 12));
+
+    encontrado |= somar(PIRAMIDE_DIA, primeiro_dia, dia_do_primeiro_mes - 1, variaveis, agregados);
+    encontrado |= somar(PIRAMIDE_DIA, dia_apos_ultimo_mes, ultimo_dia, variaveis, agregados);
+
+    // Anos inteiramente dentro dos meses inteiros.
+    long long primeiro_ano = primeiro_mes / 12 + (primeiro_mes % 12 > 0 ? 1 : 0);
+    long long ultimo_ano = ultimo_mes / 12 - (ultimo_mes % 12 < 11 ? 1 : 0);
+
+    if (primeiro_ano > ultimo_ano)
+        return somar(PIRAMIDE_MES, primeiro_mes, ultimo_mes, variaveis, agregados) || encontrado;
+
+    encontrado |= somar(PIRAMIDE_MES, primeiro_mes, primeiro_ano * 12 - 1, variaveis, agregados);
+    encontrado |= somar(PIRAMIDE_MES, (ultimo_ano + 1) * 12, ultimo_mes, variaveis, agregados);
+    encontrado |= somar(PIRAMIDE_ANO, primeiro_ano, ultimo_ano, variaveis, agregados);
+
+    return encontrado;
+}
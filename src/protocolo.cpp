@@ -0,0 +1,125 @@
+#include "protocolo.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/*
+ * @brief Envia o cabeçalho e os dados em uma única chamada sempre que possível,
+ * continuando de onde parou quando o envio sai pela metade.
+ */
+static bool enviarPartes(int conexao, const void *cabecalho, size_t tamanho_cabecalho, const char *dados, size_t tamanho)
+{
+    struct iovec partes[2] = {{(void *)cabecalho, tamanho_cabecalho}, {(void *)dados, tamanho}};
+    struct iovec *atual = partes;
+    int restantes = tamanho > 0 ? 2 : 1;
+
+    while (restantes > 0)
+    {
+        struct msghdr mensagem = {};
+        mensagem.msg_iov = atual;
+        mensagem.msg_iovlen = restantes;
+
+        // MSG_NOSIGNAL: um cliente que desconectou não derruba o servidor com SIGPIPE.
+        ssize_t n = sendmsg(conexao, &mensagem, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+
+        while (restantes > 0 && (size_t)n >= atual->iov_len)
+        {
+            n -= atual->iov_len;
+            atual++;
+            restantes--;
+        }
+
+        if (restantes > 0)
+        {
+            atual->iov_base = (char *)atual->iov_base + n;
+            atual->iov_len -= n;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * @brief Recebe exatamente 'tamanho' bytes.
+ * @return false se a conexão terminou antes.
+ */
+static bool receberTudo(int conexao, void *destino, size_t tamanho)
+{
+    char *p = (char *)destino;
+    while (tamanho > 0)
+    {
+        ssize_t n = recv(conexao, p, tamanho, 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+
+        p += n;
+        tamanho -= n;
+    }
+
+    return true;
+}
+
+int ConectarServidor(const char *caminho)
+{
+    struct sockaddr_un endereco = {};
+    endereco.sun_family = AF_UNIX;
+    if (strlen(caminho) >= sizeof(endereco.sun_path))
+        return -1;
+    strcpy(endereco.sun_path, caminho);
+
+    int conexao = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (conexao < 0)
+        return -1;
+
+    if (connect(conexao, (struct sockaddr *)&endereco, sizeof(endereco)) != 0)
+    {
+        close(conexao);
+        return -1;
+    }
+
+    return conexao;
+}
+
+bool EnviarPedido(int conexao, uint32_t numero, uint16_t estacao, uint8_t formato, const char *consulta, size_t tamanho)
+{
+    CabecalhoPedido cabecalho = {(uint32_t)tamanho, numero, estacao, formato, PROTOCOLO_VERSAO};
+    return enviarPartes(conexao, &cabecalho, sizeof(cabecalho), consulta, tamanho);
+}
+
+bool ReceberPedido(int conexao, CabecalhoPedido *cabecalho, std::string &consulta)
+{
+    if (!receberTudo(conexao, cabecalho, sizeof(*cabecalho)) || cabecalho->tamanho > PROTOCOLO_TAMANHO_CONSULTA)
+        return false;
+
+    consulta.resize(cabecalho->tamanho);
+    return receberTudo(conexao, &consulta[0], cabecalho->tamanho);
+}
+
+bool EnviarResposta(int conexao, uint32_t numero, uint8_t estado, const char *dados, size_t tamanho)
+{
+    if (tamanho > PROTOCOLO_TAMANHO_RESPOSTA)
+        return false;
+
+    CabecalhoResposta cabecalho = {(uint32_t)tamanho, numero, estado, {0, 0, 0}};
+    return enviarPartes(conexao, &cabecalho, sizeof(cabecalho), dados, tamanho);
+}
+
+bool ReceberResposta(int conexao, CabecalhoResposta *cabecalho, std::string &dados)
+{
+    if (!receberTudo(conexao, cabecalho, sizeof(*cabecalho)) || cabecalho->tamanho > PROTOCOLO_TAMANHO_RESPOSTA)
+        return false;
+
+    dados.resize(cabecalho->tamanho);
+    return receberTudo(conexao, &dados[0], cabecalho->tamanho);
+}
@@ -0,0 +1,135 @@
+#include "rastreio.h"
+
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/*
+ * Trecho terminado, com os tempos em nanossegundos desde a ativação.
+ */
+typedef struct Trecho
+{
+    const char *nome;
+    uint64_t inicio;
+    uint64_t fim;
+} Trecho;
+
+/*
+ * Buffer circular de uma thread. Só a thread que o usa no momento escreve nele.
+ */
+typedef struct BufferRastreio
+{
+    int thread;
+    uint64_t gravados = 0;
+    std::vector<Trecho> trechos;
+} BufferRastreio;
+
+static std::chrono::steady_clock::time_point origem;
+
+// Os buffers pertencem ao registro, e não às threads: continuam lá depois que elas
+// terminam, para serem salvos, e os livres são reaproveitados pelas próximas threads.
+static std::mutex trava_registro;
+static std::vector<std::unique_ptr<BufferRastreio>> buffers;
+static std::vector<BufferRastreio *> livres;
+
+/*
+ * Buffer em uso por uma thread, devolvido ao registro quando ela termina.
+ */
+class DonoBuffer
+{
+public:
+    BufferRastreio *buffer = nullptr;
+
+    ~DonoBuffer()
+    {
+        if (buffer == nullptr)
+            return;
+
+        std::lock_guard<std::mutex> trava(trava_registro);
+        livres.push_back(buffer);
+    }
+};
+
+static BufferRastreio *getBuffer()
+{
+    static thread_local DonoBuffer dono;
+    if (dono.buffer != nullptr)
+        return dono.buffer;
+
+    std::lock_guard<std::mutex> trava(trava_registro);
+    if (!livres.empty())
+    {
+        dono.buffer = livres.back();
+        livres.pop_back();
+        return dono.buffer;
+    }
+
+    buffers.emplace_back(new BufferRastreio());
+    dono.buffer = buffers.back().get();
+    dono.buffer->thread = (int)buffers.size();
+    return dono.buffer;
+}
+
+void RastreioAtivar()
+{
+    origem = std::chrono::steady_clock::now();
+    rastreio_ativo = true;
+
+    // A thread que ativa o rastreio é a primeira do registro, a principal.
+    getBuffer();
+}
+
+uint64_t RastreioAgora()
+{
+    auto duracao = std::chrono::steady_clock::now() - origem;
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(duracao).count();
+}
+
+void RastreioGravar(const char *nome, uint64_t inicio, uint64_t fim)
+{
+    BufferRastreio *buffer = getBuffer();
+
+    // Até encher, o buffer só cresce; depois, sobrescreve os trechos mais antigos.
+    if (buffer->gravados < RASTREIO_CAPACIDADE)
+        buffer->trechos.push_back(Trecho{nome, inicio, fim});
+    else
+        buffer->trechos[buffer->gravados % RASTREIO_CAPACIDADE] = Trecho{nome, inicio, fim};
+    buffer->gravados++;
+}
+
+bool RastreioSalvar(const char *caminho)
+{
+    FILE *arquivo = fopen(caminho, "w");
+    if (arquivo == nullptr)
+        return false;
+
+    std::lock_guard<std::mutex> trava(trava_registro);
+
+    fprintf(arquivo, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    fprintf(arquivo, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"series\"}}");
+
+    for (const std::unique_ptr<BufferRastreio> &buffer : buffers)
+    {
+        fprintf(arquivo, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s %d\"}}",
+                buffer->thread, buffer->thread == 1 ? "principal" : "trabalhador", buffer->thread);
+
+        // Do mais antigo ao mais novo dos trechos que ainda estão no buffer.
+        uint64_t primeiro = buffer->gravados > RASTREIO_CAPACIDADE ? buffer->gravados - RASTREIO_CAPACIDADE : 0;
+        for (uint64_t i = primeiro; i < buffer->gravados; i++)
+        {
+            const Trecho &trecho = buffer->trechos[i % RASTREIO_CAPACIDADE];
+            fprintf(arquivo, ",\n{\"name\":\"%s\",\"cat\":\"series\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    trecho.nome, buffer->thread, trecho.inicio / 1e3, (trecho.fim - trecho.inicio) / 1e3);
+        }
+
+        if (primeiro > 0)
+            fprintf(arquivo, ",\n{\"name\":\"trechos descartados\",\"ph\":\"C\",\"pid\":1,\"tid\":%d,\"ts\":0,\"args\":{\"quantidade\":%llu}}",
+                    buffer->thread, (unsigned long long)primeiro);
+    }
+
+    fprintf(arquivo, "\n]}\n");
+
+    bool ok = ferror(arquivo) == 0;
+    return fclose(arquivo) == 0 && ok;
+}
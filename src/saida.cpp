@@ -0,0 +1,66 @@
+#include "saida.h"
+
+#include <cerrno>
+#include <unistd.h>
+
+Saida::Saida(int descritor, size_t limite)
+{
+    this->descritor = descritor;
+    this->limite = descritor < 0 ? limite : 0;
+    this->buffer.resize(this->limite > 0 && this->limite < SAIDA_TAMANHO_BUFFER ? this->limite : SAIDA_TAMANHO_BUFFER);
+}
+
+Saida::~Saida()
+{
+    Descarregar();
+}
+
+void Saida::crescer(size_t tamanho)
+{
+    // Com descritor, primeiro tentamos abrir espaço escrevendo o que já temos.
+    if (descritor >= 0)
+        Descarregar();
+
+    // O buffer nunca cresce além do limite, então passar dele sempre chega aqui.
+    // O conteúdo não vai mais ser usado: as escritas seguintes reaproveitam o buffer.
+    if (limite > 0 && usado + tamanho > limite)
+    {
+        excedido = true;
+        usado = 0;
+    }
+
+    if (usado + tamanho > buffer.size())
+    {
+        size_t novo = buffer.size() * 2;
+        while (usado + tamanho > novo)
+            novo *= 2;
+        if (limite > 0 && novo > limite)
+            novo = limite > tamanho ? limite : tamanho;
+        buffer.resize(novo);
+    }
+}
+
+bool Saida::Descarregar()
+{
+    if (descritor < 0)
+        return true;
+
+    size_t escrito = 0;
+    while (escrito < usado)
+    {
+        ssize_t n = write(descritor, buffer.data() + escrito, usado - escrito);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            usado = 0;
+            falhou = true;
+            return false;
+        }
+        escrito += (size_t)n;
+    }
+
+    usado = 0;
+    return !falhou;
+}
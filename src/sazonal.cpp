@@ -0,0 +1,64 @@
+#include "sazonal.h"
+
+#include <algorithm>
+
+void IndiceSazonal::Inserir(Instante instante)
+{
+    Momento momento = Momento::DeInstante(instante);
+    celulas[momento.data.mes - 1][momento.horario.hora].push_back(instante);
+    quantidade++;
+}
+
+void IndiceSazonal::Limpar()
+{
+    for (auto &horas : celulas)
+    {
+        for (std::vector<Instante> &celula : horas)
+        {
+            celula.clear();
+            celula.shrink_to_fit();
+        }
+    }
+    quantidade = 0;
+}
+
+bool IndiceSazonal::GetCandidatos(const Momento &de, const Momento &ate, std::vector<Instante> &instantes) const
+{
+    bool possiveis[SAZONAL_MESES][SAZONAL_HORAS];
+    int quantidade_possiveis = 0;
+
+    for (int mes = 0; mes < SAZONAL_MESES; mes++)
+    {
+        for (int hora = 0; hora < SAZONAL_HORAS; hora++)
+        {
+            // Com mês e hora fixos, o maior e o menor momento possíveis da combinação.
+            // Se nem o maior alcança 'de', ou nem o menor fica abaixo de 'ate',
+            // nenhuma linha da combinação pode estar no intervalo.
+            Momento maior(31, mes + 1, INT_MAX, hora, 59);
+            Momento menor(1, mes + 1, INT_MIN, hora, 0);
+
+            possiveis[mes][hora] = maior >= de && menor <= ate;
+            if (possiveis[mes][hora])
+                quantidade_possiveis++;
+        }
+    }
+
+    if (quantidade_possiveis == SAZONAL_MESES * SAZONAL_HORAS)
+        return false;
+
+    size_t inicio = instantes.size();
+    for (int mes = 0; mes < SAZONAL_MESES; mes++)
+    {
+        for (int hora = 0; hora < SAZONAL_HORAS; hora++)
+        {
+            if (possiveis[mes][hora])
+                instantes.insert(instantes.end(), celulas[mes][hora].begin(), celulas[mes][hora].end());
+        }
+    }
+
+    // Cada combinação já está em ordem; falta intercalar as combinações entre si.
+    if (quantidade_possiveis > 1)
+        std::sort(instantes.begin() + inicio, instantes.end());
+
+    return true;
+}
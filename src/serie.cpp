@@ -1,176 +1,1308 @@
 #include "serie.h"
 
-#define QUANTIDADE_VARIAVEIS 17
+#include <cerrno>
+#include <cstring>
+#include <thread>
 
-Series::Series(const char* arquivo)
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <analisador.h>
+#include <estatisticas.h>
+#include <rastreio.h>
+#include <simd.h>
+
+/*
+ * @brief Posição logo após a última quebra de linha do trecho, ou 'inicio' se não houver.
+ */
+static const char *depoisDaUltimaQuebra(const char *inicio, const char *fim)
+{
+    const char *p = fim;
+    while (p > inicio && p[-1] != '\n')
+        p--;
+    return p;
+}
+
+/*
+ * @brief Lê até 'tamanho' bytes do arquivo a partir de 'posicao', sem mexer em
+ * nenhuma posição de leitura compartilhada.
+ * @return Quantidade de bytes lidos; menos que 'tamanho' só no fim do arquivo ou em erro.
+ */
+static size_t lerPosicao(int descritor, char *destino, size_t tamanho, uint64_t posicao)
+{
+    size_t lido = 0;
+    while (lido < tamanho)
+    {
+        ssize_t n = pread(descritor, destino + lido, tamanho - lido, (off_t)(posicao + lido));
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        lido += (size_t)n;
+    }
+    return lido;
+}
+
+Series::Series(const char* arquivo, int opcoes)
 {
-    this->fluxo = std::ifstream(arquivo);
+    RASTREAR("Series");
+
+    this->descritor = open(arquivo, O_RDONLY | O_CLOEXEC);
+    this->caminho = arquivo;
+    this->opcoes = opcoes;
+
+    // Sem suporte a mapeamento, seguimos lendo pelo descritor.
+    if (opcoes & SERIES_MAPEAR)
+        mapa.Abrir(arquivo);
+
+    this->compacto = (opcoes & SERIES_INDICE_COMPACTO) != 0;
+    this->colunar = false;
+    this->indexado = 0;
+    this->varrido = 0;
 
     Inicializar();
+
+    if (opcoes & SERIES_CARREGAR_TUDO)
+        CarregarColunas();
+
+    if (opcoes & SERIES_PIRAMIDE)
+        CarregarPiramide();
+
+    if (opcoes & SERIES_INDICE_SAZONAL)
+        CarregarSazonal();
 }
 
 void Series::Inicializar()
 {
-    // =================================================== //
-    //              Lendo cabeçalho de dados               //
+    ESTATISTICA_TEMPO(TEMPO_INICIALIZAR);
+    RASTREAR("Inicializar");
+
+    AssinaturaArquivo assinatura;
+    bool persistente = (opcoes & SERIES_INDICE_PERSISTENTE) && GetAssinatura(caminho.c_str(), &assinatura);
+
+    // Um índice salvo para este mesmo conteúdo dispensa reler o arquivo.
+    if (persistente && CarregarIndicePersistente(assinatura))
+        return;
+
+    IndexarArquivo();
+
+    // Só salvamos se o arquivo não mudou enquanto era indexado.
+    AssinaturaArquivo depois;
+    if (persistente && GetAssinatura(caminho.c_str(), &depois) &&
+        memcmp(&assinatura, &depois, sizeof(assinatura)) == 0)
+        SalvarIndicePersistente(assinatura);
+}
+
+bool Series::CarregarIndicePersistente(const AssinaturaArquivo &assinatura)
+{
+    RASTREAR("CarregarIndicePersistente");
+
+    LeitorIndice leitor;
+    std::string arquivo = caminho + PERSISTENCIA_EXTENSAO;
 
-    std::string token;
-    std::string key, value;
+    if (!leitor.Abrir(arquivo.c_str(), assinatura))
+        return false;
 
-    Momento momento;
-    Coordenada coordenada;
+    // Os registros foram salvos em ordem, então os índices são montados de uma vez,
+    // em O(n), em vez de inserir linha a linha. Fora de ordem, o índice salvo está
+    // corrompido e o arquivo é indexado de novo.
+    const RegistroIndice *registros = leitor.GetRegistros();
+    uint64_t quantidade = leitor.GetQuantidade();
 
-    fluxo.clear();
-    fluxo.seekg(0);
-    for (int i = 0; i < 8; i++)
+    std::vector<Instante> instantes(quantidade);
+    std::vector<Coordenada> coordenadas(quantidade);
+    for (uint64_t i = 0; i < quantidade; i++)
     {
-        std::getline(fluxo, token, '\n');
-        size_t symbol = token.find(';');
-        if (symbol == std::string::npos) continue;
+        const RegistroIndice &r = registros[i];
 
-        key = token.substr(0, symbol);
-        value = token.substr(symbol + 1);
+        Momento momento(r.dia, r.mes, r.ano, r.hora, r.minuto);
+        instantes[i] = momento.GetInstante();
+        coordenadas[i] = (std::streamoff)r.posicao;
+        if (i > 0 && instantes[i] <= instantes[i - 1])
+            return false;
+    }
 
-        size_t rem = key.find(':');
-        if (rem != std::string::npos)
-            key.erase(rem);
-        
+    for (auto &item : leitor.GetCabecalho())
+    {
+        std::string key = item.first, value = item.second;
         cabecalho.Inserir(key, value);
     }
 
+    ESTATISTICA_SOMAR(ESTATISTICA_LINHAS_INDEXADAS, quantidade);
+
+    // O índice compacto já recebe cada hora em O(1); se o arquivo não couber nele,
+    // a árvore é montada com todos os registros.
+    if (compacto)
+    {
+        for (uint64_t i = 0; i < quantidade; i++)
+        {
+            const RegistroIndice &r = registros[i];
+            if (!horario.Inserir(Momento(r.dia, r.mes, r.ano, r.hora, r.minuto), r.posicao))
+            {
+                horario = IndiceHorario();
+                compacto = false;
+                break;
+            }
+        }
+    }
+
+    if (!compacto)
+        dados.Construir(instantes.data(), coordenadas.data(), quantidade);
+
+    // O índice salvo cobre o arquivo inteiro do momento em que foi salvo. Atualizar
+    // recomeça do início da última linha, que pode não ter terminado.
+    varrido = indexado = assinatura.tamanho;
+
+    Mapeamento arquivo_mapeado;
+    if (arquivo_mapeado.Abrir(caminho.c_str()) && arquivo_mapeado.GetTamanho() >= varrido)
+    {
+        const char *inicio = arquivo_mapeado.GetDados();
+        indexado = depoisDaUltimaQuebra(inicio, inicio + varrido) - inicio;
+    }
+
+    return true;
+}
+
+void Series::SalvarIndicePersistente(const AssinaturaArquivo &assinatura)
+{
+    RASTREAR("SalvarIndicePersistente");
+
+    CabecalhoPersistido itens;
+    auto chaves = cabecalho.Listar([](std::string) -> bool { return true; });
+    for (auto no : chaves)
+        itens.emplace_back(no->chave, no->valor);
+
+    std::vector<EntradaIndice> entradas;
+    ListarIndice(entradas);
+
+    std::vector<RegistroIndice> registros;
+    registros.reserve(entradas.size());
+    for (EntradaIndice &e : entradas)
+    {
+        Momento &m = e.momento;
+        registros.push_back(RegistroIndice{m.data.ano, (int8_t)m.data.mes, (int8_t)m.data.dia,
+                                           (int8_t)m.horario.hora, (int8_t)m.horario.minuto,
+                                           (uint64_t)(std::streamoff)e.coordenada});
+    }
+
+    // Sem permissão de escrita ao lado do CSV, apenas seguimos sem o índice salvo.
+    std::string arquivo = caminho + PERSISTENCIA_EXTENSAO;
+    SalvarIndice(arquivo.c_str(), assinatura, itens, registros);
+}
+
+void Series::ListarIndice(std::vector<EntradaIndice> &entradas)
+{
+    if (compacto)
+    {
+        entradas.reserve(entradas.size() + horario.GetQuantidade());
+        for (long long h = 0; h < horario.GetTamanho(); h++)
+        {
+            if (horario.IsPresente(h))
+                entradas.push_back(EntradaIndice{horario.GetMomento(h), (std::streamoff)horario.GetPosicao(h)});
+        }
+        return;
+    }
+
+    dados.ParaCada([&entradas](Arvore<Instante, Coordenada>::No *no) -> bool
+                   {
+                       entradas.push_back(EntradaIndice{Momento::DeInstante(no->chave), no->valor});
+                       return true;
+                   });
+}
+
+void Series::DecodificarLinhas(const std::vector<EntradaIndice> &entradas,
+                               const std::function<void(const Momento &, const double *)> &visitante)
+{
+    double valores[QUANTIDADE_VARIAVEIS];
+
+    // Decodificar direto da memória evita uma leitura por linha no arquivo.
+    Mapeamento temporario;
+    const Mapeamento *origem = &mapa;
+    if (!ConferirMapa() && temporario.Abrir(caminho.c_str()))
+        origem = &temporario;
+
+    Linha linha;
+
+    for (const EntradaIndice &entrada : entradas)
+    {
+        bool lido;
+        if (origem->IsAberto())
+        {
+            size_t posicao = (size_t)(std::streamoff)entrada.coordenada;
+            lido = posicao < origem->GetTamanho() &&
+                   LerLinha(origem->GetDados() + posicao, origem->GetDados() + origem->GetTamanho(), &linha);
+        }
+        else
+            lido = LerLinha(entrada.coordenada, &linha);
+
+        // Linhas que não puderam ser decodificadas ficam de fora, como em GetLinhas.
+        if (!lido)
+            continue;
+
+        for (int i = 0; i < QUANTIDADE_VARIAVEIS; i++)
+            valores[i] = linha.*VARIAVEIS_LINHA[i];
+
+        visitante(entrada.momento, valores);
+    }
+}
+
+void Series::CarregarColunas()
+{
+    RASTREAR("CarregarColunas");
+
+    std::vector<EntradaIndice> entradas;
+    ListarIndice(entradas);
+
+    colunas.Limpar();
+    colunas.Reservar((long long)entradas.size());
+
+    DecodificarLinhas(entradas, [this](const Momento &momento, const double *valores)
+                      { colunas.Adicionar(momento, valores); });
+
+    colunar = true;
+}
+
+void Series::CarregarPiramide()
+{
+    RASTREAR("CarregarPiramide");
+
+    piramide.Limpar();
+
+    // Com as colunas carregadas, não é preciso voltar ao arquivo.
+    if (colunar)
+    {
+        double valores[QUANTIDADE_VARIAVEIS];
+        for (long long l = 0; l < colunas.GetQuantidade(); l++)
+        {
+            for (int i = 0; i < QUANTIDADE_VARIAVEIS; i++)
+                valores[i] = colunas.GetColuna(i)[l];
+
+            piramide.Adicionar(colunas.GetMomento(l), valores);
+        }
+        return;
+    }
+
+    std::vector<EntradaIndice> entradas;
+    ListarIndice(entradas);
+
+    DecodificarLinhas(entradas, [this](const Momento &momento, const double *valores)
+                      { piramide.Adicionar(momento, valores); });
+}
+
+void Series::CarregarSazonal()
+{
+    RASTREAR("CarregarSazonal");
+
+    sazonal.Limpar();
+
+    if (colunar)
+    {
+        for (long long l = 0; l < colunas.GetQuantidade(); l++)
+            sazonal.Inserir(colunas.GetInstante(l));
+        return;
+    }
+
+    std::vector<EntradaIndice> entradas;
+    ListarIndice(entradas);
+
+    for (EntradaIndice &entrada : entradas)
+        sazonal.Inserir(entrada.momento.GetInstante());
+}
+
+void Series::LerColunas(long long indice, Linha *linha)
+{
+    linha->momento = colunas.GetMomento(indice);
+    for (int i = 0; i < QUANTIDADE_VARIAVEIS; i++)
+        linha->*VARIAVEIS_LINHA[i] = colunas.GetColuna(i)[indice];
+}
+
+void Series::IndexarArquivo()
+{
+    // A indexação paralela precisa do arquivo inteiro em memória: se ele não foi
+    // mapeado para as leituras, mapeamos só durante a indexação.
+    Mapeamento temporario;
+    const Mapeamento *origem = &mapa;
+    if (!mapa.IsAberto() && (opcoes & SERIES_PARALELO) && temporario.Abrir(caminho.c_str()))
+        origem = &temporario;
+
+    // Com o arquivo mapeado, todo o conteúdo já está disponível em memória.
+    if (origem->IsAberto())
+    {
+        const char *inicio = origem->GetDados();
+        const char *fim = inicio + origem->GetTamanho();
+
+        ESTATISTICA_SOMAR(ESTATISTICA_BYTES_INDEXADOS, fim - inicio);
+
+        size_t cabecalho_lido = LerCabecalho(inicio, fim);
+        if (opcoes & SERIES_PARALELO)
+            IndexarParalelo(inicio + cabecalho_lido, fim, cabecalho_lido);
+        else
+            IndexarBloco(inicio + cabecalho_lido, fim, cabecalho_lido, true);
+
+        varrido = fim - inicio;
+        indexado = depoisDaUltimaQuebra(inicio, fim) - inicio;
+        return;
+    }
+
+    if (descritor < 0)
+        return;
+
+    // Sem mapeamento, lemos o arquivo em blocos e indexamos as linhas completas
+    // de cada bloco. O pedaço de linha que sobra no fim é levado para o próximo.
+    std::vector<char> buffer(SERIES_TAMANHO_BLOCO);
+    size_t pendente = 0;
+    uint64_t deslocamento = 0;
+    bool cabecalho_lido = false;
+
+    while (true)
+    {
+        size_t pedido = buffer.size() - pendente, lido;
+        {
+            RASTREAR("LerBloco");
+            lido = lerPosicao(descritor, buffer.data() + pendente, pedido, deslocamento + pendente);
+        }
+        ESTATISTICA_SOMAR(ESTATISTICA_SEEKS, 1);
+        ESTATISTICA_SOMAR(ESTATISTICA_BYTES_LIDOS, lido);
+        ESTATISTICA_SOMAR(ESTATISTICA_BYTES_INDEXADOS, lido);
+        size_t total = pendente + lido;
+        bool final = lido < pedido;
+
+        const char *inicio = buffer.data();
+        size_t consumido = 0;
+
+        if (!cabecalho_lido)
+        {
+            consumido = LerCabecalho(inicio, inicio + total);
+            cabecalho_lido = true;
+        }
+
+        consumido += IndexarBloco(inicio + consumido, inicio + total, deslocamento + consumido, final);
+        if (final)
+        {
+            varrido = deslocamento + total;
+            indexado = deslocamento + (depoisDaUltimaQuebra(inicio, inicio + total) - inicio);
+            break;
+        }
+
+        pendente = total - consumido;
+        memmove(buffer.data(), buffer.data() + consumido, pendente);
+        deslocamento += consumido;
+
+        // Uma única linha maior que o bloco: aumentamos o buffer.
+        if (pendente == buffer.size())
+            buffer.resize(buffer.size() * 2);
+    }
+}
+
+size_t Series::LerCabecalho(const char *inicio, const char *fim)
+{
+    RASTREAR("LerCabecalho");
+
+    // =================================================== //
+    //              Lendo cabeçalho de dados               //
+
+    const char *p = inicio;
+
+    // 8 linhas de 'chave:;valor', seguidas da linha de títulos (ignorada).
+    for (int i = 0; i < 9 && p < fim; i++)
+    {
+        const char *quebra = (const char *)memchr(p, '\n', fim - p);
+        const char *fim_linha = quebra != nullptr ? quebra : fim;
+
+        const char *simbolo = i < 8 ? (const char *)memchr(p, ';', fim_linha - p) : nullptr;
+        if (simbolo != nullptr)
+        {
+            const char *fim_chave = (const char *)memchr(p, ':', simbolo - p);
+
+            std::string key(p, fim_chave != nullptr ? fim_chave : simbolo);
+            std::string value(simbolo + 1, fim_linha);
+
+            cabecalho.Inserir(key, value);
+        }
+
+        p = quebra != nullptr ? quebra + 1 : fim;
+    }
+
+    return p - inicio;
+}
+
+size_t Series::AnalisarBloco(const char *inicio, const char *fim, uint64_t deslocamento, bool final,
+                             std::vector<EntradaIndice> &entradas)
+{
+    RASTREAR("AnalisarBloco");
+
     // ==================================================== //
     //              Indexando série de linhas               //
 
-    std::getline(fluxo, token, '\n'); // Linha de títulos. (Ignoramos)
-    
-    std::streampos inicio_da_linha = fluxo.tellg();
+    EntradaIndice entrada;
+    Varredor varredor(inicio, fim);
+    long long invalidas = 0;
 
-    while (!fluxo.eof())
+    const char *p = inicio;
+    while (p < fim)
     {
-        std::getline(fluxo, token, '\n');
+        // Os dois primeiros delimitadores da linha separam a data e o horário.
+        const char *data = varredor.Proximo();
+        const char *hora = data < fim && *data == ';' ? varredor.Proximo() : data;
+        const char *quebra = hora < fim && *hora == ';' ? varredor.ProximaQuebra() : hora;
 
-        if (token.empty()) {
-            inicio_da_linha = fluxo.tellg();
-            continue;
+        // Linha incompleta: só indexamos se não há mais nada para ler.
+        if (quebra == fim && !final)
+            break;
+
+        // Linhas vazias (ou malformadas) são ignoradas.
+        if (hora < quebra && AnalisarData(p, data, &entrada.momento.data) &&
+            AnalisarHorario(data + 1, hora, &entrada.momento.horario))
+        {
+            // ---- A coordenada aponta para o início dos valores da linha.
+            entrada.coordenada = (std::streamoff)(deslocamento + (hora + 1 - inicio));
+            entradas.push_back(entrada);
+        }
+        else if (quebra > p && !(quebra - p == 1 && *p == '\r'))
+            invalidas++;
+
+        p = quebra < fim ? quebra + 1 : fim;
+    }
+
+    ESTATISTICA_SOMAR(ESTATISTICA_LINHAS_INVALIDAS, invalidas);
+    return p - inicio;
+}
+
+size_t Series::IndexarBloco(const char *inicio, const char *fim, uint64_t deslocamento, bool final)
+{
+    entradas.clear();
+    size_t consumido = AnalisarBloco(inicio, fim, deslocamento, final, entradas);
+
+    RASTREAR("InserirIndice");
+    for (EntradaIndice &entrada : entradas)
+        Indexar(entrada.momento, entrada.coordenada);
+
+    return consumido;
+}
+
+void Series::IndexarParalelo(const char *inicio, const char *fim, uint64_t deslocamento)
+{
+    // Uma tarefa por núcleo, sem criar tarefas para pedaços menores que um bloco.
+    size_t tamanho = fim - inicio;
+    size_t tarefas = std::thread::hardware_concurrency();
+    if (tarefas > tamanho / SERIES_TAMANHO_BLOCO)
+        tarefas = tamanho / SERIES_TAMANHO_BLOCO;
+
+    if (tarefas <= 1)
+    {
+        IndexarBloco(inicio, fim, deslocamento, true);
+        return;
+    }
+
+    // Cada pedaço termina logo após uma quebra de linha, então nenhuma linha é dividida.
+    std::vector<const char *> limites(tarefas + 1);
+    limites[0] = inicio;
+    limites[tarefas] = fim;
+    for (size_t i = 1; i < tarefas; i++)
+    {
+        const char *p = inicio + tamanho / tarefas * i;
+        if (p < limites[i - 1])
+            p = limites[i - 1];
+
+        const char *quebra = (const char *)memchr(p, '\n', fim - p);
+        limites[i] = quebra != nullptr ? quebra + 1 : fim;
+    }
+
+    std::vector<std::vector<EntradaIndice>> pedacos(tarefas);
+    std::vector<std::thread> trabalhadores;
+
+    for (size_t i = 0; i < tarefas; i++)
+    {
+        trabalhadores.emplace_back([&, i]()
+                                   { AnalisarBloco(limites[i], limites[i + 1], deslocamento + (limites[i] - inicio), true, pedacos[i]); });
+    }
+
+    for (std::thread &trabalhador : trabalhadores)
+        trabalhador.join();
+
+    // Juntamos os pedaços na ordem do arquivo: o índice fica idêntico ao da
+    // indexação sequencial, inclusive para momentos repetidos.
+    RASTREAR("InserirIndice");
+    for (std::vector<EntradaIndice> &pedaco : pedacos)
+    {
+        for (EntradaIndice &entrada : pedaco)
+            Indexar(entrada.momento, entrada.coordenada);
+
+        pedaco.clear();
+        pedaco.shrink_to_fit();
+    }
+}
+
+bool Series::Atualizar(long long *novas)
+{
+    RASTREAR("Atualizar");
+
+    if (novas != nullptr)
+        *novas = 0;
+
+    std::vector<char> buffer;
+    const char *inicio, *fim;
+
+    if (mapa.IsAberto())
+    {
+        // O mapeamento só cobre o tamanho que o arquivo tinha quando foi aberto.
+        bool aberto = mapa.Abrir(caminho.c_str());
+        encolhido = false;
+        if (!aberto || mapa.GetTamanho() < varrido)
+            return false;
+
+        inicio = mapa.GetDados() + indexado;
+        fim = mapa.GetDados() + mapa.GetTamanho();
+    }
+    else
+    {
+        if (descritor < 0)
+            descritor = open(caminho.c_str(), O_RDONLY | O_CLOEXEC);
+        if (descritor < 0)
+            return false;
+
+        size_t total = 0, lido;
+        do
+        {
+            buffer.resize(total + SERIES_TAMANHO_BLOCO);
+            lido = lerPosicao(descritor, buffer.data() + total, SERIES_TAMANHO_BLOCO, indexado + total);
+            total += lido;
+            ESTATISTICA_SOMAR(ESTATISTICA_SEEKS, 1);
+        } while (lido == SERIES_TAMANHO_BLOCO);
+        ESTATISTICA_SOMAR(ESTATISTICA_BYTES_LIDOS, total);
+
+        if (indexado + total < varrido)
+            return false;
+
+        inicio = buffer.data();
+        fim = inicio + total;
+    }
+
+    const char *p = inicio;
+    if (indexado == 0)
+    {
+        // Nada indexado ainda: o cabeçalho só é lido quando as suas 9 linhas estão completas.
+        const char *q = p;
+        for (int i = 0; i < 9 && q != nullptr; i++)
+        {
+            q = (const char *)memchr(q, '\n', fim - q);
+            if (q != nullptr)
+                q++;
         }
 
-        std::stringstream stream(token);
+        if (q == nullptr)
+            return true;
 
-        // ---- Adquirindo momento a partir do stringstream.
-        std::getline(stream, key, ';');
-        momento.data.ano = std::stoi(key.substr(0, 4));
-        momento.data.mes = std::stoi(key.substr(5, 2));
-        momento.data.dia = std::stoi(key.substr(8, 2));
-        
-        std::getline(stream, key, ';');
-        
-        size_t symbol = key.find(':');
-        if (symbol != std::string::npos)
-            key.replace(symbol, 1, "");
-        
-        momento.horario.hora = std::stoi(key.substr(0, 2));
-        momento.horario.minuto = std::stoi(key.substr(2, 2));
-        
-        // ---- Adquirindo posição (EVITAR ALTERAÇÕES).
-        coordenada = inicio_da_linha + (std::streamoff)stream.tellg();
+        p += LerCabecalho(p, fim);
+    }
+
+    // Só as linhas completas: a última, se ainda está sendo escrita, fica para depois.
+    std::vector<EntradaIndice> encontradas;
+    uint64_t posicao = indexado + (p - inicio);
+    size_t consumido = AnalisarBloco(p, fim, posicao, false, encontradas);
+    ESTATISTICA_SOMAR(ESTATISTICA_BYTES_INDEXADOS, consumido);
 
-        this->dados.Inserir(momento, coordenada);
-        inicio_da_linha = fluxo.tellg();
+    // A última linha da carga pode ter sido indexada pela metade, sem a quebra de
+    // linha. Agora completa, só os valores dela são trocados: ela não entra de novo
+    // no índice, nem obriga a recalcular as colunas e a pirâmide inteiras.
+    size_t repetidas = 0;
+    Instante ultimo;
+    if (!encontradas.empty() && (uint64_t)(std::streamoff)encontradas[0].coordenada < varrido &&
+        GetUltimoInstante(&ultimo) && encontradas[0].momento.GetInstante() == ultimo)
+    {
+        SubstituirUltima(encontradas[0]);
+        encontradas.erase(encontradas.begin());
+        repetidas = 1;
     }
+
+    indexado = posicao + consumido;
+    if (varrido < indexado)
+        varrido = indexado;
+
+    IndexarNovas(encontradas);
+
+    if (novas != nullptr)
+        *novas = (long long)encontradas.size();
+    return true;
 }
 
+bool Series::GetUltimoInstante(Instante *instante)
+{
+    if (compacto)
+    {
+        // A última hora do índice compacto é sempre uma hora presente.
+        if (horario.GetTamanho() == 0)
+            return false;
+
+        *instante = horario.GetMomento(horario.GetTamanho() - 1).GetInstante();
+        return true;
+    }
+
+    Arvore<Instante, Coordenada>::No *maior = dados.GetMaior();
+    if (maior == nullptr)
+        return false;
+
+    *instante = maior->chave;
+    return true;
+}
+
+void Series::IndexarNovas(const std::vector<EntradaIndice> &novas)
+{
+    if (novas.empty())
+        return;
+
+    // Conferido antes de indexar: as linhas novas precisam vir depois de todas as
+    // anteriores, sem repetir instantes, para serem só acrescentadas.
+    Instante ultimo;
+    bool anterior = GetUltimoInstante(&ultimo);
+    bool em_ordem = true;
+    for (const EntradaIndice &entrada : novas)
+    {
+        Instante instante = entrada.momento.GetInstante();
+        if (anterior && instante <= ultimo)
+        {
+            em_ordem = false;
+            break;
+        }
+
+        ultimo = instante;
+        anterior = true;
+    }
+
+    {
+        RASTREAR("InserirIndice");
+        for (const EntradaIndice &entrada : novas)
+        {
+            Momento momento = entrada.momento;
+            Indexar(momento, entrada.coordenada);
+        }
+    }
+
+    bool piramidal = (opcoes & SERIES_PIRAMIDE) != 0;
+
+    if (!em_ordem)
+    {
+        if (colunar)
+            CarregarColunas();
+        if (piramidal)
+            CarregarPiramide();
+        if (opcoes & SERIES_INDICE_SAZONAL)
+            CarregarSazonal();
+        return;
+    }
+
+    if (colunar || piramidal)
+    {
+        DecodificarLinhas(novas, [this, piramidal](const Momento &momento, const double *valores)
+                          {
+                              if (colunar)
+                                  colunas.Adicionar(momento, valores);
+                              if (piramidal)
+                                  piramide.Adicionar(momento, valores);
+                          });
+    }
+
+    if (opcoes & SERIES_INDICE_SAZONAL)
+    {
+        for (const EntradaIndice &entrada : novas)
+            sazonal.Inserir(entrada.momento.GetInstante());
+    }
+}
+
+void Series::SubstituirUltima(const EntradaIndice &entrada)
+{
+    RASTREAR("SubstituirUltima");
+
+    if (colunar)
+    {
+        DecodificarLinhas({entrada}, [this](const Momento &, const double *valores)
+                          {
+                              colunas.SubstituirUltima(valores);
+                          });
+    }
+
+    // Refazemos o último dia com as linhas dele, já com a última completa.
+    if (opcoes & SERIES_PIRAMIDE)
+    {
+        piramide.RemoverUltimoDia();
+
+        Momento dia(entrada.momento.data, Horario());
+        ParaCada(dia, dia, [this](const Linha &linha) -> bool
+                 {
+                     double valores[QUANTIDADE_VARIAVEIS];
+                     for (int i = 0; i < QUANTIDADE_VARIAVEIS; i++)
+                         valores[i] = linha.*VARIAVEIS_LINHA[i];
+
+                     piramide.Adicionar(linha.momento, valores);
+                     return true;
+                 });
+    }
+}
+
+void Series::Indexar(Momento &momento, Coordenada coordenada)
+{
+    ESTATISTICA_SOMAR(ESTATISTICA_LINHAS_INDEXADAS, 1);
+
+    if (compacto)
+    {
+        if (horario.Inserir(momento, (uint64_t)(std::streamoff)coordenada))
+            return;
+
+        // O arquivo não é estritamente horário: voltamos para a árvore.
+        for (long long h = 0; h < horario.GetTamanho(); h++)
+        {
+            if (!horario.IsPresente(h))
+                continue;
+
+            Instante i = horario.GetMomento(h).GetInstante();
+            Coordenada c = (std::streamoff)horario.GetPosicao(h);
+            dados.Inserir(i, c);
+        }
+
+        horario = IndiceHorario();
+        compacto = false;
+    }
+
+    Instante instante = momento.GetInstante();
+    dados.Inserir(instante, coordenada);
+}
+
+bool Series::ConferirMapa()
+{
+    if (!mapa.IsAberto() || encolhido)
+        return false;
+
+    if (mapa.Conferir())
+        return true;
+
+    encolhido = true;
+    return false;
+}
 
 bool Series::LerLinha(Coordenada coord, Linha *l)
 {
     // ==================================================== //
     //              Leitura de linha indexada               //
 
-    std::string line, token;
-    int comma;
+    ESTATISTICA_TEMPO(TEMPO_LER_LINHA);
+
+    size_t posicao = (size_t)(std::streamoff)coord;
+
+    // Com o arquivo mapeado, a linha é lida direto da memória.
+    if (mapa.IsAberto() && !encolhido)
+    {
+        if (posicao >= mapa.GetTamanho())
+            return false;
+
+        // O fim da linha é encontrado pelo próprio decodificador.
+        const char *inicio = mapa.GetDados() + posicao;
+        return LerLinha(inicio, mapa.GetDados() + mapa.GetTamanho(), l);
+    }
+
+    if (descritor < 0)
+        return false;
+
+    // Lemos a linha pela posição, em um buffer da própria chamada: nada é
+    // compartilhado, então várias threads podem ler linhas ao mesmo tempo.
+    char local[SERIES_TAMANHO_LINHA];
+    std::vector<char> longa;
+    char *buffer = local;
+    size_t capacidade = sizeof(local), usado = 0;
+    const char *quebra = nullptr;
+    {
+        RASTREAR("LerArquivo");
+
+        while (true)
+        {
+            size_t lido = lerPosicao(descritor, buffer + usado, capacidade - usado, posicao + usado);
+            ESTATISTICA_SOMAR(ESTATISTICA_SEEKS, 1);
+
+            quebra = (const char *)memchr(buffer + usado, '\n', lido);
+            usado += lido;
+            if (quebra != nullptr || usado < capacidade)
+                break;
 
-    if (!fluxo.is_open())
+            // Linha maior que o buffer: continuamos em um buffer maior.
+            longa.resize(capacidade * 2);
+            if (buffer == local)
+                memcpy(longa.data(), local, usado);
+            buffer = longa.data();
+            capacidade = longa.size();
+        }
+        ESTATISTICA_SOMAR(ESTATISTICA_BYTES_LIDOS, usado);
+    }
+
+    // A posição ficou depois do fim: o arquivo encolheu desde a indexação.
+    if (usado == 0)
         return false;
 
-    fluxo.clear();
-    fluxo.seekg(coord, std::ios::beg);
+    return LerLinha(buffer, quebra != nullptr ? quebra : buffer + usado, l);
+}
 
-    // Fazemos a leitura da linha inteira que contém os valores.
-    std::getline(fluxo, line, '\n');
-    std::stringstream stream(line);
+bool Series::LerLinha(const char *inicio, const char *fim, Linha *l)
+{
+    RASTREAR("DecodificarLinha");
 
-    // Ordem definida nos arquivos do INMET
-    double *variaveis[QUANTIDADE_VARIAVEIS] = {&l->precipitacao_total, &l->pressao_atmosferica, &l->pressao_atmosferica_max,
-                             &l->pressao_atmosferica_min, &l->radiacao_global, &l->temperatura_ar,
-                             &l->temperatura_orvalho, &l->temperatura_ar_max, &l->temperatura_ar_min,
-                             &l->temperatura_orvalho_max, &l->temperatura_orvalho_min, &l->umidade_relativa_max,
-                             &l->umidade_relativa_min, &l->umidade_relativa, &l->vento_direcao,
-                             &l->vento_rajada, &l->vento_velocidade};
+    Varredor varredor(inicio, fim);
+    const char *campo = inicio;
 
     for (int i = 0; i < QUANTIDADE_VARIAVEIS; i++)
     {
-        double *p = variaveis[i];
+        // Depois do fim da linha, os campos que faltam são tratados como vazios.
+        const char *separador = campo < fim ? varredor.Proximo() : fim;
+        bool fim_da_linha = separador == fim || *separador == '\n';
 
-        std::getline(stream, token, ';');
-        // Caso a entrada esteja vazia ou o valor seja igual -9999 (Compatibilidade)
-        if (token.empty() || token.compare("-9999") == 0) {
-            *p = -1.0f;
-            continue;
+        // Campos vazios ou com -9999 ficam marcados como ausentes.
+        if (!AnalisarValor(campo, separador, VALOR_AUSENTE, &(l->*VARIAVEIS_LINHA[i])))
+        {
+            ESTATISTICA_SOMAR(ESTATISTICA_FALHAS_LEITURA, 1);
+            return false;
         }
 
-        // Precisamos corrigir um problema...
-        // stod espera por um ponto ao em vez de virgula...
-        // Para esta correção, então, substituimos todos os pontos por virgula.   
-        comma = token.find(',');
-        if(comma != std::string::npos)
-            token.replace(comma, 1, ".");
-
-        // Inserimos na variável o valor lido.
-        *p = std::stod(token);
+        campo = fim_da_linha ? fim : separador + 1;
     }
 
+    ESTATISTICA_SOMAR(ESTATISTICA_LINHAS_DECODIFICADAS, 1);
     return true;
 }
 
 bool Series::GetLinha(Momento m, Linha *linha)
 {
-    if (linha == nullptr)
+    ESTATISTICA_TEMPO(TEMPO_GET_LINHA);
+    RASTREAR("GetLinha");
+
+    // Um momento fora do calendário não existe no arquivo; convertido, cairia em outro dia.
+    if (linha == nullptr || !m.IsValido())
+        return false;
+
+    ConferirMapa();
+
+    // Campos ignorados fora de ordem: a primeira linha vem do índice sazonal.
+    if (!sazonal.IsVazio() && !m.IsOrdenavel())
+    {
+        VisitanteLinha primeira = [linha](const Linha &encontrada) -> bool
+        {
+            *linha = encontrada;
+            return false;
+        };
+
+        bool usado;
+        bool encontrado = ParaCadaSazonal(m, m, primeira, &usado);
+        if (usado)
+            return encontrado;
+    }
+
+    if (colunar)
+    {
+        long long indice;
+        if (m.IsOrdenavel())
+        {
+            // Primeira linha do intervalo de instantes coberto pelo momento.
+            indice = colunas.LimiteInferior(m.GetInstanteInferior());
+            if (indice >= colunas.GetQuantidade() || colunas.GetInstante(indice) > m.GetInstanteSuperior())
+                return false;
+        }
+        else
+        {
+            // Momento com campos ignorados fora de ordem: comparamos campo a campo.
+            for (indice = 0; indice < colunas.GetQuantidade(); indice++)
+            {
+                if (colunas.GetMomento(indice) == m)
+                    break;
+            }
+
+            if (indice >= colunas.GetQuantidade())
+                return false;
+        }
+
+        LerColunas(indice, linha);
+        return true;
+    }
+
+    if (compacto)
+    {
+        uint64_t posicao;
+
+        if (m.IsCompleto())
+        {
+            if (!horario.Buscar(m, &posicao))
+                return false;
+
+            linha->momento = m;
+            return LerLinha((std::streamoff)posicao, linha);
+        }
+
+        if (horario.IsVazio())
+            return false;
+
+        // Momento parcial: primeira linha que combina com os campos informados.
+        // Se ele é ordenável, só as horas entre os limites dele podem combinar.
+        long long primeira = 0, ultima = horario.GetTamanho() - 1;
+        if (m.IsOrdenavel() && m.data.ano != MOMENTO_DONT_COMPARE &&
+            !horario.GetIntervalo(m.GetLimiteInferior(), m.GetLimiteSuperior(), &primeira, &ultima))
+            return false;
+
+        for (long long h = primeira; h <= ultima; h++)
+        {
+            if (horario.IsPresente(h) && horario.GetMomento(h) == m)
+            {
+                linha->momento = horario.GetMomento(h);
+                return LerLinha((std::streamoff)horario.GetPosicao(h), linha);
+            }
+        }
         return false;
+    }
 
-    auto no = dados.Buscar(m);
+    Arvore<Instante, Coordenada>::No *no = nullptr;
+    auto primeiro = [&no](Arvore<Instante, Coordenada>::No *encontrado) -> bool
+    {
+        no = encontrado;
+        return false;
+    };
+
+    if (m.IsCompleto())
+    {
+        Instante instante = m.GetInstante();
+        no = dados.Buscar(instante);
+    }
+    else if (m.IsOrdenavel())
+    {
+        Instante inicio = m.GetInstanteInferior(), fim = m.GetInstanteSuperior();
+        dados.ParaCadaIntervalo(inicio, fim, primeiro);
+    }
+    else
+    {
+        // Momento com campos ignorados fora de ordem: comparamos campo a campo.
+        dados.ParaCada([&](Arvore<Instante, Coordenada>::No *candidato) -> bool
+                       {
+                           if (Momento::DeInstante(candidato->chave) != m)
+                               return true;
+                           return primeiro(candidato);
+                       });
+    }
 
     if (no == nullptr) // Nossa linha não foi encontrada
         return false;
 
+    linha->momento = Momento::DeInstante(no->chave);
     return LerLinha(no->valor, linha);
 }
 
 bool Series::GetLinhas(Momento de, Momento ate, Lista<Linha> *linhas)
 {
+    ESTATISTICA_TEMPO(TEMPO_GET_LINHAS);
+    RASTREAR("GetLinhas");
+
     if (linhas == nullptr)
         return false;
 
-    auto lista = dados.Listar([&de, &ate](Momento momento_no) -> bool
-                           { 
-                            return momento_no >= de && momento_no <= ate; 
-                        });
+    return ParaCada(de, ate, [linhas](const Linha &linha) -> bool
+                    {
+                        linhas->Inserir(linha);
+                        return true;
+                    });
+}
 
-    if (lista.IsVazio()) // Nenhuma linha foi encontrada
+bool Series::ParaCada(Momento de, Momento ate, VisitanteLinha visitante)
+{
+    ESTATISTICA_TEMPO(TEMPO_PARA_CADA);
+    RASTREAR("ParaCada");
+
+    if (!de.IsValido() || !ate.IsValido())
         return false;
-    
-    for(auto i = lista.GetInicio(); i != nullptr; i = i->proximo) {
-        Linha linha;
 
-        linha.momento = i->valor->chave;
-        if(!LerLinha(i->valor->valor, &linha))
+    ConferirMapa();
+
+    // Campos ignorados fora de ordem: o índice sazonal evita percorrer a série inteira.
+    if (!sazonal.IsVazio() && !(de.IsOrdenavel() && ate.IsOrdenavel()))
+    {
+        bool usado;
+        bool encontrado = ParaCadaSazonal(de, ate, visitante, &usado);
+        if (usado)
+            return encontrado;
+    }
+
+    if (colunar)
+        return ParaCadaColunas(de, ate, visitante);
+
+    if (compacto)
+        return ParaCadaCompacto(de, ate, visitante);
+
+    // A mesma linha é reaproveitada para todas as linhas visitadas.
+    Linha linha;
+    bool encontrado = false, lido = true;
+
+    auto visitar = [&](Arvore<Instante, Coordenada>::No *no) -> bool
+    {
+        encontrado = true;
+
+        linha.momento = Momento::DeInstante(no->chave);
+        if (!LerLinha(no->valor, &linha))
+        {
+            lido = false;
             return false;
+        }
 
-        linhas->Inserir(linha);
-    }    
+        return visitante(linha);
+    };
 
-    return true;
+    // Com campos ignorados apenas no fim, os limites viram um intervalo de instantes
+    // e podemos descartar as sub-árvores fora dele.
+    if (de.IsOrdenavel() && ate.IsOrdenavel())
+    {
+        Instante inicio = de.GetInstanteInferior(), fim = ate.GetInstanteSuperior();
+        dados.ParaCadaIntervalo(inicio, fim, visitar);
+    }
+    else
+        dados.ParaCada([&](Arvore<Instante, Coordenada>::No *no) -> bool
+                       {
+                           Momento momento = Momento::DeInstante(no->chave);
+                           if (!(momento >= de && momento <= ate))
+                               return true;
+                           return visitar(no);
+                       });
+
+    return encontrado && lido;
+}
+
+bool Series::ParaCadaSazonal(Momento &de, Momento &ate, VisitanteLinha &visitante, bool *usado)
+{
+    std::vector<Instante> candidatos;
+    *usado = sazonal.GetCandidatos(de, ate, candidatos);
+    if (!*usado)
+        return false;
+
+    Linha linha;
+    bool encontrado = false;
+    for (Instante instante : candidatos)
+    {
+        // Dia, minuto e ano não são filtrados pelo índice: conferimos cada candidato.
+        Momento momento = Momento::DeInstante(instante);
+        if (!(momento >= de && momento <= ate))
+            continue;
+
+        if (!LerInstante(instante, &linha))
+            return false;
+
+        encontrado = true;
+        if (!visitante(linha))
+            break;
+    }
+
+    return encontrado;
+}
+
+bool Series::LerInstante(Instante instante, Linha *linha)
+{
+    if (colunar)
+    {
+        long long indice = colunas.LimiteInferior(instante);
+        if (indice >= colunas.GetQuantidade() || colunas.GetInstante(indice) != instante)
+            return false;
+
+        LerColunas(indice, linha);
+        return true;
+    }
+
+    linha->momento = Momento::DeInstante(instante);
+
+    if (compacto)
+    {
+        uint64_t posicao;
+        return horario.Buscar(linha->momento, &posicao) && LerLinha((std::streamoff)posicao, linha);
+    }
+
+    auto no = dados.Buscar(instante);
+    return no != nullptr && LerLinha(no->valor, linha);
+}
+
+bool Series::ParaCadaCompacto(Momento &de, Momento &ate, VisitanteLinha &visitante)
+{
+    if (horario.IsVazio())
+        return false;
+
+    long long primeira = 0, ultima = horario.GetTamanho() - 1;
+
+    // Com limites ordenáveis, o intervalo vira uma fatia contígua do índice.
+    bool ordenado = de.IsOrdenavel() && ate.IsOrdenavel();
+    if (ordenado)
+    {
+        Momento inicio = de.data.ano != MOMENTO_DONT_COMPARE ? de.GetLimiteInferior() : horario.GetMomento(0);
+        Momento fim = ate.data.ano != MOMENTO_DONT_COMPARE ? ate.GetLimiteSuperior() : horario.GetMomento(ultima);
+
+        if (!horario.GetIntervalo(inicio, fim, &primeira, &ultima))
+            return false;
+    }
+
+    Linha linha;
+    bool encontrado = false;
+    for (long long h = primeira; h <= ultima; h++)
+    {
+        if (!horario.IsPresente(h))
+            continue;
+
+        linha.momento = horario.GetMomento(h);
+
+        if (!ordenado && !(linha.momento >= de && linha.momento <= ate))
+            continue;
+
+        if (!LerLinha((std::streamoff)horario.GetPosicao(h), &linha))
+            return false;
+
+        encontrado = true;
+        if (!visitante(linha))
+            break;
+    }
+
+    return encontrado;
+}
+
+bool Series::ParaCadaColunas(Momento &de, Momento &ate, VisitanteLinha &visitante)
+{
+    long long primeira = 0, fim = colunas.GetQuantidade();
+
+    // Com limites ordenáveis, o intervalo é encontrado por busca binária.
+    bool ordenado = de.IsOrdenavel() && ate.IsOrdenavel();
+    if (ordenado)
+    {
+        primeira = colunas.LimiteInferior(de.GetInstanteInferior());
+        fim = colunas.LimiteSuperior(ate.GetInstanteSuperior());
+    }
+
+    Linha linha;
+    bool encontrado = false;
+    for (long long i = primeira; i < fim; i++)
+    {
+        if (!ordenado)
+        {
+            Momento momento = colunas.GetMomento(i);
+            if (!(momento >= de && momento <= ate))
+                continue;
+        }
+
+        LerColunas(i, &linha);
+
+        encontrado = true;
+        if (!visitante(linha))
+            break;
+    }
+
+    return encontrado;
+}
+
+bool Series::Agregar(Momento de, Momento ate, unsigned variaveis, Agregado *agregados)
+{
+    ESTATISTICA_TEMPO(TEMPO_AGREGAR);
+    RASTREAR("Agregar");
+
+    if (agregados == nullptr || !de.IsValido() || !ate.IsValido())
+        return false;
+
+    if (piramide.IsVazia() || !de.IsOrdenavel() || !ate.IsOrdenavel())
+        return AgregarLinhas(de, ate, variaveis, agregados);
+
+    // Limites completos do intervalo; sem ano, o intervalo vai até a ponta dos dados.
+    Momento inicio = de.data.ano != MOMENTO_DONT_COMPARE ? de.GetLimiteInferior()
+                                                          : Momento(DataDeDias(piramide.GetPrimeiroDia()), Horario(0, 0));
+    Momento fim = ate.data.ano != MOMENTO_DONT_COMPARE ? ate.GetLimiteSuperior()
+                                                        : Momento(DataDeDias(piramide.GetUltimoDia()), Horario(23, 59));
+
+    // Dias inteiramente dentro do intervalo vêm da pirâmide.
+    bool inicio_quebrado = inicio.horario.hora != 0 || inicio.horario.minuto != 0;
+    bool fim_quebrado = fim.horario.hora != 23 || fim.horario.minuto != 59;
+    long long primeiro_dia = DiasDesdeEpoca(inicio.data.dia, inicio.data.mes, inicio.data.ano) + (inicio_quebrado ? 1 : 0);
+    long long ultimo_dia = DiasDesdeEpoca(fim.data.dia, fim.data.mes, fim.data.ano) - (fim_quebrado ? 1 : 0);
+
+    if (primeiro_dia > ultimo_dia)
+        return AgregarLinhas(inicio, fim, variaveis, agregados);
+
+    // As horas das pontas, fora dos dias inteiros, são lidas linha a linha.
+    bool encontrado = false;
+    if (inicio_quebrado)
+    {
+        Momento antes(DataDeDias(primeiro_dia - 1), Horario(23, 59));
+        encontrado |= AgregarLinhas(inicio, antes, variaveis, agregados);
+    }
+
+    encontrado |= piramide.Agregar(primeiro_dia, ultimo_dia, variaveis, agregados);
+
+    if (fim_quebrado)
+    {
+        Momento depois(DataDeDias(ultimo_dia + 1), Horario(0, 0));
+        encontrado |= AgregarLinhas(depois, fim, variaveis, agregados);
+    }
+
+    return encontrado;
+}
+
+bool Series::AgregarLinhas(Momento &de, Momento &ate, unsigned variaveis, Agregado *agregados)
+{
+    RASTREAR("AgregarLinhas");
+
+    // Com limites fora de ordem e o índice sazonal, visitar só os candidatos
+    // sai mais barato que varrer todas as colunas.
+    bool ordenado = de.IsOrdenavel() && ate.IsOrdenavel();
+    if (colunar && (ordenado || sazonal.IsVazio()))
+    {
+        long long primeira = 0, fim = colunas.GetQuantidade();
+
+        if (ordenado)
+        {
+            primeira = colunas.LimiteInferior(de.GetInstanteInferior());
+            fim = colunas.LimiteSuperior(ate.GetInstanteSuperior());
+        }
+
+        // Agregamos cada trecho contíguo de linhas dentro do intervalo.
+        bool encontrado = false;
+        long long i = primeira;
+        while (i < fim)
+        {
+            while (!ordenado && i < fim && !(colunas.GetMomento(i) >= de && colunas.GetMomento(i) <= ate))
+                i++;
+
+            long long j = i;
+            while (j < fim && (ordenado || (colunas.GetMomento(j) >= de && colunas.GetMomento(j) <= ate)))
+                j++;
+
+            if (j == i)
+                break;
+
+            for (int v = 0; v < QUANTIDADE_VARIAVEIS; v++)
+            {
+                if (variaveis & (1u << v))
+                    AgregarColuna(colunas.GetColuna(v) + i, j - i, &agregados[v]);
+            }
+
+            encontrado = true;
+            i = j;
+        }
+
+        return encontrado;
+    }
+
+    AgregadorLinhas agregador(variaveis, agregados);
+    bool encontrado = ParaCada(de, ate, [&agregador](const Linha &linha) -> bool
+                               {
+                                   agregador.Adicionar(linha);
+                                   return true;
+                               });
+    agregador.Concluir();
+
+    return encontrado;
+}
+
+void AgregadorLinhas::Concluir()
+{
+    for (int v = 0; v < QUANTIDADE_VARIAVEIS; v++)
+    {
+        if (variaveis & (1u << v))
+            AgregarColuna(bloco[v], quantidade, &agregados[v]);
+    }
+    quantidade = 0;
 }
 
 Series::~Series()
 {
-    this->fluxo.clear();
+    if (this->descritor >= 0)
+        close(this->descritor);
 }
@@ -0,0 +1,298 @@
+#include "servidor.h"
+
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <consulta.h>
+#include <protocolo.h>
+#include <rastreio.h>
+
+Servidor::Servidor(const char *caminho, const std::vector<Series *> &estacoes, int trabalhadores)
+{
+    this->caminho = caminho;
+    this->estacoes = estacoes;
+    this->trabalhadores = trabalhadores > 0 ? trabalhadores : 1;
+}
+
+Servidor::~Servidor()
+{
+    if (escuta >= 0)
+    {
+        close(escuta);
+        unlink(caminho.c_str());
+    }
+
+    for (int ponta : despertador)
+    {
+        if (ponta >= 0)
+            close(ponta);
+    }
+}
+
+bool Servidor::Abrir()
+{
+    struct sockaddr_un endereco = {};
+    endereco.sun_family = AF_UNIX;
+    if (caminho.size() >= sizeof(endereco.sun_path))
+        return false;
+    strcpy(endereco.sun_path, caminho.c_str());
+
+    // Se ninguém responde no caminho, o socket é de um servidor que já terminou.
+    int outro = ConectarServidor(caminho.c_str());
+    if (outro >= 0)
+    {
+        close(outro);
+        return false;
+    }
+    unlink(caminho.c_str());
+
+    if (despertador[0] < 0 && pipe2(despertador, O_CLOEXEC | O_NONBLOCK) != 0)
+        return false;
+
+    // Sem bloqueio: uma conexão desistida entre o poll e o accept não trava o servidor.
+    int s = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (s < 0)
+        return false;
+
+    if (bind(s, (struct sockaddr *)&endereco, sizeof(endereco)) != 0 || listen(s, SOMAXCONN) != 0)
+    {
+        close(s);
+        return false;
+    }
+
+    escuta = s;
+    return true;
+}
+
+void Servidor::Parar()
+{
+    // Só uma chamada de sistema segura em tratadores de sinal: o accept
+    // bloqueado em Servir retorna com erro, e Servir faz o resto.
+    if (escuta >= 0)
+        shutdown(escuta, SHUT_RDWR);
+}
+
+void Servidor::Servir()
+{
+    std::vector<std::thread> threads;
+    for (int t = 0; t < trabalhadores; t++)
+        threads.emplace_back(&Servidor::Trabalhar, this);
+
+    // Conexões sem pedido em andamento, observadas só por esta thread.
+    std::vector<int> ociosas;
+    std::vector<struct pollfd> eventos;
+
+    while (true)
+    {
+        {
+            std::lock_guard<std::mutex> guarda(trava);
+            ociosas.insert(ociosas.end(), devolvidas.begin(), devolvidas.end());
+            devolvidas.clear();
+        }
+
+        eventos.clear();
+        eventos.push_back({escuta, POLLIN, 0});
+        eventos.push_back({despertador[0], POLLIN, 0});
+        for (int conexao : ociosas)
+            eventos.push_back({conexao, POLLIN, 0});
+
+        if (poll(eventos.data(), eventos.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        if (eventos[1].revents != 0)
+        {
+            char descarte[64];
+            while (read(despertador[0], descarte, sizeof(descarte)) > 0)
+                ;
+        }
+
+        // Conexões com um pedido chegando, ou fechadas pelo cliente, vão para os trabalhadores.
+        size_t restantes = 0;
+        bool prontas = false;
+        {
+            std::lock_guard<std::mutex> guarda(trava);
+            for (size_t i = 0; i < ociosas.size(); i++)
+            {
+                if (eventos[i + 2].revents != 0)
+                {
+                    pendentes.push_back(ociosas[i]);
+                    prontas = true;
+                }
+                else
+                    ociosas[restantes++] = ociosas[i];
+            }
+        }
+        ociosas.resize(restantes);
+        if (prontas)
+            sinal.notify_all();
+
+        // Parar desliga o socket de escuta; sem bloqueio, o accept só diria EAGAIN.
+        if (eventos[0].revents & (POLLHUP | POLLERR | POLLNVAL))
+            break;
+        if (eventos[0].revents == 0)
+            continue;
+
+        int conexao = accept4(escuta, nullptr, nullptr, SOCK_CLOEXEC);
+        if (conexao < 0)
+        {
+            // Sinais e conexões desistidas antes do accept não encerram o servidor.
+            if (errno == EINTR || errno == ECONNABORTED || errno == EAGAIN || errno == EWOULDBLOCK)
+                continue;
+            break;
+        }
+
+        {
+            std::lock_guard<std::mutex> guarda(trava);
+            if (conexoes >= SERVIDOR_CONEXOES_MAXIMAS)
+            {
+                close(conexao);
+                continue;
+            }
+            conexoes++;
+        }
+
+        // Um pedido pela metade, ou um cliente que não lê as respostas, não prendem
+        // um trabalhador para sempre.
+        struct timeval limite = {SERVIDOR_TEMPO_LIMITE, 0};
+        setsockopt(conexao, SOL_SOCKET, SO_RCVTIMEO, &limite, sizeof(limite));
+        setsockopt(conexao, SOL_SOCKET, SO_SNDTIMEO, &limite, sizeof(limite));
+
+        ociosas.push_back(conexao);
+    }
+
+    // Conexões em atendimento são interrompidas; as demais, só fechadas.
+    {
+        std::lock_guard<std::mutex> guarda(trava);
+        encerrando = true;
+        for (int conexao : ativas)
+            shutdown(conexao, SHUT_RDWR);
+        for (int conexao : pendentes)
+            close(conexao);
+        for (int conexao : devolvidas)
+            close(conexao);
+        pendentes.clear();
+        devolvidas.clear();
+    }
+    sinal.notify_all();
+
+    for (int conexao : ociosas)
+        close(conexao);
+
+    for (std::thread &thread : threads)
+        thread.join();
+
+    close(escuta);
+    unlink(caminho.c_str());
+    escuta = -1;
+}
+
+void Servidor::Trabalhar()
+{
+    while (true)
+    {
+        int conexao;
+        {
+            std::unique_lock<std::mutex> guarda(trava);
+            sinal.wait(guarda, [this]() { return encerrando || !pendentes.empty(); });
+            if (encerrando)
+                return;
+
+            conexao = pendentes.front();
+            pendentes.pop_front();
+            ativas.push_back(conexao);
+        }
+
+        bool aberta = Atender(conexao);
+
+        std::lock_guard<std::mutex> guarda(trava);
+        for (size_t i = 0; i < ativas.size(); i++)
+        {
+            if (ativas[i] == conexao)
+            {
+                ativas[i] = ativas.back();
+                ativas.pop_back();
+                break;
+            }
+        }
+
+        if (aberta && !encerrando)
+        {
+            devolvidas.push_back(conexao);
+
+            // Com o pipe cheio a escrita falha, mas o poll já tem o que o acorde.
+            char aviso = 0;
+            ssize_t escrito = write(despertador[1], &aviso, 1);
+            (void)escrito;
+        }
+        else
+        {
+            close(conexao);
+            conexoes--;
+        }
+    }
+}
+
+bool Servidor::Atender(int conexao)
+{
+    // A resposta é montada em memória e enviada com o cabeçalho, que leva o tamanho.
+    Saida resposta(-1, PROTOCOLO_TAMANHO_RESPOSTA);
+    CabecalhoPedido pedido;
+    std::string texto;
+
+    if (!ReceberPedido(conexao, &pedido, texto))
+        return false;
+
+    RASTREAR("Pedido");
+
+    uint8_t estado = PROTOCOLO_OK;
+    int formato = pedido.formato == FORMATO_JSON ? FORMATO_JSON : FORMATO_CSV;
+
+    if (pedido.versao != PROTOCOLO_VERSAO)
+    {
+        EscreverErro(pedido.numero, "versão do protocolo desconhecida", formato, resposta);
+        estado = PROTOCOLO_ERRO_PEDIDO;
+    }
+    else if (pedido.estacao >= estacoes.size())
+    {
+        EscreverErro(pedido.numero, "estação desconhecida", formato, resposta);
+        estado = PROTOCOLO_ERRO_PEDIDO;
+    }
+    else if (pedido.formato != FORMATO_CSV && pedido.formato != FORMATO_JSON)
+    {
+        EscreverErro(pedido.numero, "formato desconhecido", formato, resposta);
+        estado = PROTOCOLO_ERRO_PEDIDO;
+    }
+    else
+    {
+        // Linhas vazias e comentários têm uma resposta vazia, como no modo --batch.
+        Consulta consulta;
+        const char *erro;
+        if (AnalisarConsulta(texto.data(), texto.data() + texto.size(), &consulta, &erro))
+            ExecutarConsulta(*estacoes[pedido.estacao], consulta, pedido.numero, formato, resposta);
+        else if (erro != nullptr)
+        {
+            EscreverErro(pedido.numero, erro, formato, resposta);
+            estado = PROTOCOLO_ERRO_CONSULTA;
+        }
+    }
+
+    if (resposta.IsExcedida())
+    {
+        resposta.Limpar();
+        EscreverErro(pedido.numero, "resposta grande demais; divida o intervalo", formato, resposta);
+        estado = PROTOCOLO_ERRO_RESPOSTA;
+    }
+
+    return EnviarResposta(conexao, pedido.numero, estado, resposta.GetDados(), resposta.GetTamanho());
+}
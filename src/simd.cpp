@@ -0,0 +1,140 @@
+#include "simd.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_X86
+#endif
+
+static void mascararEscalar(const char *bloco, uint64_t *linhas, uint64_t *campos)
+{
+    uint64_t l = 0, c = 0;
+    for (int i = 0; i < SIMD_TAMANHO_BLOCO; i++)
+    {
+        l |= (uint64_t)(bloco[i] == '\n') << i;
+        c |= (uint64_t)(bloco[i] == ';') << i;
+    }
+    *linhas = l;
+    *campos = c;
+}
+
+#ifdef SIMD_X86
+__attribute__((target("sse2"))) static void mascararSse2(const char *bloco, uint64_t *linhas, uint64_t *campos)
+{
+    const __m128i quebra = _mm_set1_epi8('\n');
+    const __m128i separador = _mm_set1_epi8(';');
+
+    uint64_t l = 0, c = 0;
+    for (int i = 0; i < SIMD_TAMANHO_BLOCO; i += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(bloco + i));
+        l |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, quebra)) << i;
+        c |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, separador)) << i;
+    }
+    *linhas = l;
+    *campos = c;
+}
+
+__attribute__((target("avx2"))) static void mascararAvx2(const char *bloco, uint64_t *linhas, uint64_t *campos)
+{
+    const __m256i quebra = _mm256_set1_epi8('\n');
+    const __m256i separador = _mm256_set1_epi8(';');
+
+    __m256i baixo = _mm256_loadu_si256((const __m256i *)bloco);
+    __m256i alto = _mm256_loadu_si256((const __m256i *)(bloco + 32));
+
+    *linhas = (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(baixo, quebra)) |
+              (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(alto, quebra)) << 32;
+    *campos = (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(baixo, separador)) |
+              (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(alto, separador)) << 32;
+}
+#endif
+
+typedef void (*FuncaoMascara)(const char *, uint64_t *, uint64_t *);
+
+static int nivelSuportado()
+{
+#ifdef SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return SIMD_AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return SIMD_SSE2;
+#endif
+    return SIMD_ESCALAR;
+}
+
+static FuncaoMascara funcaoDoNivel(int nivel)
+{
+#ifdef SIMD_X86
+    if (nivel == SIMD_AVX2)
+        return mascararAvx2;
+    if (nivel == SIMD_SSE2)
+        return mascararSse2;
+#endif
+    return mascararEscalar;
+}
+
+static int nivel = nivelSuportado();
+static FuncaoMascara mascarar = funcaoDoNivel(nivel);
+
+void MascararBloco(const char *bloco, uint64_t *linhas, uint64_t *campos)
+{
+    mascarar(bloco, linhas, campos);
+}
+
+int SimdGetNivel()
+{
+    return nivel;
+}
+
+int SimdDefinirNivel(int desejado)
+{
+    int suportado = nivelSuportado();
+    nivel = desejado < suportado ? desejado : suportado;
+    mascarar = funcaoDoNivel(nivel);
+    return nivel;
+}
+
+const char *SimdGetNome(int nivel)
+{
+    switch (nivel)
+    {
+    case SIMD_AVX2:
+        return "avx2";
+    case SIMD_SSE2:
+        return "sse2";
+    default:
+        return "escalar";
+    }
+}
+
+Varredor::Varredor(const char *inicio, const char *fim)
+{
+    this->fim = fim;
+    this->linhas = 0;
+    this->campos = 0;
+    this->bloco = inicio;
+
+    if (inicio < fim)
+        carregar(inicio);
+}
+
+void Varredor::carregar(const char *inicio)
+{
+    bloco = inicio;
+
+    if (fim - inicio >= SIMD_TAMANHO_BLOCO)
+    {
+        mascarar(inicio, &linhas, &campos);
+        return;
+    }
+
+    // Último bloco, menor que 64 bytes: analisamos uma cópia completada com zeros.
+    char copia[SIMD_TAMANHO_BLOCO] = {0};
+    size_t tamanho = fim - inicio;
+    memcpy(copia, inicio, tamanho);
+
+    mascarar(copia, &linhas, &campos);
+}
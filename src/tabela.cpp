@@ -0,0 +1,194 @@
+#include "tabela.h"
+
+#include <charconv>
+
+// Largura da tabela alinhada, contando as barras entre as colunas.
+#define TABELA_LARGURA 274
+
+// Largura do rótulo das linhas do rodapé.
+#define TABELA_LARGURA_ROTULO 28
+
+// Variáveis na ordem das colunas da tabela, e a largura de cada coluna.
+static const int ordem[QUANTIDADE_VARIAVEIS] = {
+    VARIAVEL_PRECIPITACAO_TOTAL, VARIAVEL_RADIACAO_GLOBAL, VARIAVEL_PRESSAO_ATMOSFERICA,
+    VARIAVEL_PRESSAO_ATMOSFERICA_MAX, VARIAVEL_PRESSAO_ATMOSFERICA_MIN, VARIAVEL_TEMPERATURA_AR,
+    VARIAVEL_TEMPERATURA_AR_MAX, VARIAVEL_TEMPERATURA_AR_MIN, VARIAVEL_TEMPERATURA_ORVALHO,
+    VARIAVEL_TEMPERATURA_ORVALHO_MAX, VARIAVEL_TEMPERATURA_ORVALHO_MIN, VARIAVEL_UMIDADE_RELATIVA,
+    VARIAVEL_UMIDADE_RELATIVA_MAX, VARIAVEL_UMIDADE_RELATIVA_MIN, VARIAVEL_VENTO_DIRECAO,
+    VARIAVEL_VENTO_VELOCIDADE, VARIAVEL_VENTO_RAJADA};
+static const int larguras[QUANTIDADE_VARIAVEIS] = {13, 16, 12, 16, 16, 12, 14, 14, 14, 14, 14, 10, 13, 13, 14, 11, 12};
+
+static const char *const titulos[QUANTIDADE_VARIAVEIS] = {
+    "Precipitacao", "Radiacao Global", "Pressao", "Pressao Max", "Pressao Min", "Temp. Ar",
+    "Temp. Ar Max", "Temp. Ar Min", "Temp. Orvalho", "Temp. Or. Max", "Temp. Or. Min", "Umidade",
+    "Umidade Max", "Umidade Min", "Vento Direcao", "Vento Vel.", "Vento Rajada"};
+static const char *const unidades[QUANTIDADE_VARIAVEIS] = {
+    "(mm)", "(Kj/m^2)", "(mB)", "(mB)", "(mB)", "(oC)", "(oC)", "(oC)", "(oC)",
+    "(oC)", "(oC)", "(%)", "(%)", "(%)", "(ogr)", "(m/s)", "(m/s)"};
+
+// Colunas do momento: largura, título e unidade na tabela alinhada, e nome em CSV/TSV.
+static const int larguras_momento[TABELA_COLUNAS_MOMENTO] = {4, 4, 6, 5, 5};
+static const char *const titulos_momento[TABELA_COLUNAS_MOMENTO] = {"Dia", "Mes", "Ano", "Hora", "Min"};
+static const char *const unidades_momento[TABELA_COLUNAS_MOMENTO] = {"dd", "mm", "aaaa", "hh", "MM"};
+static const char *const nomes_momento[TABELA_COLUNAS_MOMENTO] = {"dia", "mes", "ano", "hora", "minuto"};
+
+Tabela::Tabela(Saida &saida, int formato) : saida(saida)
+{
+    this->formato = formato;
+    this->separador = formato == TABELA_TSV ? '\t' : ',';
+}
+
+void Tabela::escreverCelula(const char *texto, int largura)
+{
+    size_t tamanho = strlen(texto);
+    saida.Escrever(texto, tamanho);
+
+    if (formato != TABELA_ALINHADA)
+        return;
+
+    // Como no "%-*s" do printf: alinhado à esquerda, sem cortar o que passar da largura.
+    if (tamanho < (size_t)largura)
+        saida.EscreverRepetido(' ', largura - tamanho);
+    saida.Escrever('|');
+}
+
+void Tabela::escreverInteiro(long long valor, int largura)
+{
+    char texto[SAIDA_TAMANHO_NUMERO];
+    *std::to_chars(texto, texto + sizeof(texto) - 1, valor).ptr = '\0';
+    escreverCelula(texto, largura);
+}
+
+void Tabela::escreverValor(double valor, int largura)
+{
+    char texto[SAIDA_TAMANHO_NUMERO];
+
+    if (IsAusente(valor))
+        texto[0] = '\0';
+    else if (formato == TABELA_ALINHADA)
+    {
+        // Duas casas, como o "%.2f" usado antes; números enormes saem na forma curta.
+        std::to_chars_result resultado = std::to_chars(texto, texto + sizeof(texto) - 1, valor, std::chars_format::fixed, 2);
+        if (resultado.ec != std::errc())
+            resultado = std::to_chars(texto, texto + sizeof(texto) - 1, valor);
+        *resultado.ptr = '\0';
+    }
+    else
+    {
+        // Em CSV e TSV o valor sai na menor forma que o lê de volta sem perdas.
+        *std::to_chars(texto, texto + sizeof(texto) - 1, valor).ptr = '\0';
+    }
+
+    escreverCelula(texto, largura);
+}
+
+void Tabela::escreverSeparador()
+{
+    if (formato != TABELA_ALINHADA)
+        saida.Escrever(separador);
+}
+
+void Tabela::escreverLinhaDivisoria()
+{
+    saida.EscreverRepetido('-', TABELA_LARGURA);
+    saida.Escrever('\n');
+}
+
+void Tabela::escreverRotulo(const char *rotulo)
+{
+    // Alinhado à direita, como no "%28s" do printf.
+    size_t tamanho = strlen(rotulo);
+    if (tamanho < TABELA_LARGURA_ROTULO)
+        saida.EscreverRepetido(' ', TABELA_LARGURA_ROTULO - tamanho);
+    saida.Escrever(rotulo, tamanho);
+    saida.Escrever('|');
+}
+
+void Tabela::EscreverCabecalho()
+{
+    if (formato != TABELA_ALINHADA)
+    {
+        for (int i = 0; i < TABELA_COLUNAS_MOMENTO; i++)
+        {
+            if (i > 0)
+                escreverSeparador();
+            escreverCelula(nomes_momento[i], 0);
+        }
+        for (int i = 0; i < QUANTIDADE_VARIAVEIS; i++)
+        {
+            escreverSeparador();
+            escreverCelula(NOMES_VARIAVEIS[ordem[i]], 0);
+        }
+        saida.Escrever('\n');
+        return;
+    }
+
+    for (int i = 0; i < TABELA_COLUNAS_MOMENTO; i++)
+        escreverCelula(titulos_momento[i], larguras_momento[i]);
+    for (int i = 0; i < QUANTIDADE_VARIAVEIS; i++)
+        escreverCelula(titulos[i], larguras[i]);
+    saida.Escrever('\n');
+
+    for (int i = 0; i < TABELA_COLUNAS_MOMENTO; i++)
+        escreverCelula(unidades_momento[i], larguras_momento[i]);
+    for (int i = 0; i < QUANTIDADE_VARIAVEIS; i++)
+        escreverCelula(unidades[i], larguras[i]);
+    saida.Escrever('\n');
+
+    escreverLinhaDivisoria();
+}
+
+void Tabela::EscreverLinha(const Linha &linha)
+{
+    const int campos[TABELA_COLUNAS_MOMENTO] = {
+        linha.momento.data.dia, linha.momento.data.mes, linha.momento.data.ano,
+        linha.momento.horario.hora, linha.momento.horario.minuto};
+
+    for (int i = 0; i < TABELA_COLUNAS_MOMENTO; i++)
+    {
+        if (i > 0)
+            escreverSeparador();
+        escreverInteiro(campos[i], larguras_momento[i]);
+    }
+
+    for (int i = 0; i < QUANTIDADE_VARIAVEIS; i++)
+    {
+        escreverSeparador();
+        escreverValor(linha.*VARIAVEIS_LINHA[ordem[i]], larguras[i]);
+    }
+
+    saida.Escrever('\n');
+}
+
+void Tabela::EscreverRodape(const Agregado *agregados)
+{
+    if (formato != TABELA_ALINHADA)
+        return;
+
+    escreverLinhaDivisoria();
+
+    escreverRotulo("Medias: ");
+    for (int i = 0; i < QUANTIDADE_VARIAVEIS; i++)
+        escreverValor(agregados[ordem[i]].GetMedia(), larguras[i]);
+    saida.Escrever('\n');
+
+    escreverRotulo("Soma total:");
+    for (int i = 0; i < QUANTIDADE_VARIAVEIS; i++)
+        escreverValor(agregados[ordem[i]].soma, larguras[i]);
+    saida.Escrever('\n');
+
+    escreverRotulo("Maiores valores:");
+    for (int i = 0; i < QUANTIDADE_VARIAVEIS; i++)
+        escreverValor(agregados[ordem[i]].GetMaximo(), larguras[i]);
+    saida.Escrever('\n');
+
+    escreverRotulo("Menores valores:");
+    for (int i = 0; i < QUANTIDADE_VARIAVEIS; i++)
+        escreverValor(agregados[ordem[i]].GetMinimo(), larguras[i]);
+    saida.Escrever('\n');
+
+    escreverRotulo("Valores presentes:");
+    for (int i = 0; i < QUANTIDADE_VARIAVEIS; i++)
+        escreverInteiro(agregados[ordem[i]].validos, larguras[i]);
+    saida.Escrever('\n');
+}
@@ -0,0 +1,315 @@
+#include <analisador.h>
+#include <arvore.h>
+#include <consulta.h>
+#include <gerador.h>
+#include <indice.h>
+#include <momento.h>
+#include <serie.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*
+ * Testes de regressão, sem framework: cada CONFERIR que falha é mostrado com a
+ * linha dele, e o programa termina com erro se algum falhou. Rodados pelo ctest.
+ */
+
+static int falhas = 0;
+
+#define CONFERIR(condicao)                                                  \
+    do                                                                      \
+    {                                                                       \
+        if (!(condicao))                                                    \
+        {                                                                   \
+            fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #condicao); \
+            falhas++;                                                       \
+        }                                                                   \
+    } while (0)
+
+static bool analisarData(const char *texto, Data *data)
+{
+    return AnalisarData(texto, texto + strlen(texto), data);
+}
+
+static bool analisarMomento(const char *texto, Momento *momento)
+{
+    return AnalisarMomento(texto, texto + strlen(texto), momento);
+}
+
+static Momento completo(int dia, int mes, int ano, int hora, int minuto = 0)
+{
+    return Momento(dia, mes, ano, hora, minuto);
+}
+
+static void testarDatasImpossiveis()
+{
+    Data data;
+    CONFERIR(analisarData("2024/02/29", &data));
+    CONFERIR(!analisarData("2023/02/29", &data));
+    CONFERIR(!analisarData("2024/02/30", &data));
+    CONFERIR(!analisarData("2024/04/31", &data));
+    CONFERIR(!analisarData("2024/13/01", &data));
+    CONFERIR(!analisarData("2024/00/10", &data));
+    CONFERIR(!analisarData("2024/01/00", &data));
+    CONFERIR(analisarData("2000/02/29", &data));
+    CONFERIR(!analisarData("1900/02/29", &data));
+
+    Momento momento;
+    CONFERIR(analisarMomento("2024-02-29T12:00", &momento));
+    CONFERIR(analisarMomento("*-02-29", &momento));
+    CONFERIR(!analisarMomento("2023-02-29", &momento));
+    CONFERIR(!analisarMomento("*-02-30", &momento));
+    CONFERIR(!analisarMomento("2024-13", &momento));
+    CONFERIR(!analisarMomento("2024-01-01T24:00", &momento));
+    CONFERIR(!analisarMomento("2024-01-01T00:60", &momento));
+
+    CONFERIR(DiasNoMes(2, 2024) == 29);
+    CONFERIR(DiasNoMes(2, 2023) == 28);
+    CONFERIR(DiasNoMes(13, 2024) == 0);
+    CONFERIR(DiasNoMes(0, 2024) == 0);
+
+    CONFERIR(completo(29, 2, 2024, 0).IsValido());
+    CONFERIR(!completo(29, 2, 2023, 0).IsValido());
+    CONFERIR(!completo(31, 4, 2024, 0).IsValido());
+    CONFERIR(!Momento(1, 13, 2024, MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE).IsValido());
+    CONFERIR(Momento(29, 2, MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE).IsValido());
+    CONFERIR(!Momento(30, 2, MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE).IsValido());
+}
+
+static void testarInstantes()
+{
+    // Do começo de 1999 ao fim de 2025, passando por anos bissextos e 2000.
+    Momento inicio = completo(1, 1, 1999, 0);
+    long long horas = inicio.GetHoras();
+    for (long long h = horas; h < horas + 27LL * 366 * 24; h += 7)
+    {
+        Momento momento = Momento::DeHoras(h);
+        CONFERIR(momento.IsValido());
+        CONFERIR(momento.GetHoras() == h);
+        CONFERIR(Momento::DeInstante(momento.GetInstante()) == momento);
+    }
+
+    Momento minuto = completo(31, 12, 2024, 23, 59);
+    CONFERIR(Momento::DeInstante(minuto.GetInstante()) == minuto);
+    CONFERIR(completo(1, 1, 2025, 0).GetInstante() == minuto.GetInstante() + 1);
+    CONFERIR(completo(1, 3, 2024, 0).GetHoras() - completo(28, 2, 2024, 0).GetHoras() == 48);
+
+    // Os limites de um momento parcial são o primeiro e o último minuto dele.
+    Momento fevereiro(MOMENTO_DONT_COMPARE, 2, 2024, MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE);
+    CONFERIR(fevereiro.GetLimiteInferior() == completo(1, 2, 2024, 0, 0));
+    CONFERIR(fevereiro.GetLimiteSuperior() == completo(29, 2, 2024, 23, 59));
+}
+
+static void testarArvore()
+{
+    Arvore<Instante, long long> arvore;
+    Momento inicio = completo(1, 1, 2023, 0);
+    for (long long h = 0; h < 2 * 366 * 24; h += 3)
+    {
+        Instante instante = Momento::DeHoras(inicio.GetHoras() + h).GetInstante();
+        arvore.Inserir(instante, h);
+    }
+
+    // Remove um dia inteiro: o intervalo dele fica vazio, e os vizinhos continuam.
+    Momento dia(10, 3, 2023, MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE);
+    Instante de = dia.GetInstanteInferior(), ate = dia.GetInstanteSuperior();
+    for (Instante i = de; i <= ate; i += 60)
+        arvore.Remover(i);
+
+    long long visitados = 0;
+    arvore.ParaCadaIntervalo(de, ate, [&](Arvore<Instante, long long>::No *) -> bool
+                             {
+                                 visitados++;
+                                 return true;
+                             });
+    CONFERIR(visitados == 0);
+
+    Momento marco(MOMENTO_DONT_COMPARE, 3, 2023, MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE);
+    de = marco.GetInstanteInferior();
+    ate = marco.GetInstanteSuperior();
+    Instante anterior = de - 1;
+    bool ordem = true;
+    arvore.ParaCadaIntervalo(de, ate, [&](Arvore<Instante, long long>::No *no) -> bool
+                             {
+                                 ordem = ordem && no->chave > anterior && no->chave <= ate;
+                                 anterior = no->chave;
+                                 visitados++;
+                                 return true;
+                             });
+    CONFERIR(ordem);
+    CONFERIR(visitados == 30 * 8);
+
+    // O intervalo de um dia que não existe converteria para outro dia.
+    Instante primeiro = completo(1, 3, 2023, 0).GetInstante();
+    CONFERIR(arvore.Buscar(primeiro) != nullptr);
+    CONFERIR(!completo(29, 2, 2023, 0).IsValido());
+
+    // Montada de uma vez a partir de chaves ordenadas, a árvore é a mesma.
+    std::vector<Instante> chaves;
+    std::vector<long long> valores;
+    arvore.ParaCada([&](Arvore<Instante, long long>::No *no) -> bool
+                    {
+                        chaves.push_back(no->chave);
+                        valores.push_back(no->valor);
+                        return true;
+                    });
+    Arvore<Instante, long long> construida;
+    construida.Construir(chaves.data(), valores.data(), chaves.size());
+    long long iguais = 0;
+    size_t i = 0;
+    construida.ParaCada([&](Arvore<Instante, long long>::No *no) -> bool
+                        {
+                            if (i < chaves.size() && no->chave == chaves[i] && no->valor == valores[i])
+                                iguais++;
+                            i++;
+                            return true;
+                        });
+    CONFERIR(iguais == (long long)chaves.size() && i == chaves.size());
+}
+
+static void testarIndiceHorario()
+{
+    IndiceHorario indice;
+    CONFERIR(!indice.Inserir(completo(1, 1, 2023, 0, 30), 0));
+
+    Momento inicio = completo(1, 1, 2023, 0);
+    for (long long h = 0; h < 366 * 24; h++)
+    {
+        // Um dia inteiro sem linhas, como uma falha na estação.
+        Momento momento = Momento::DeHoras(inicio.GetHoras() + h);
+        if (momento.data.mes == 3 && momento.data.dia == 10)
+            continue;
+        CONFERIR(indice.Inserir(momento, (uint64_t)h * 100));
+    }
+
+    uint64_t posicao;
+    CONFERIR(indice.Buscar(completo(2, 1, 2023, 5), &posicao) && posicao == 29 * 100);
+    CONFERIR(!indice.Buscar(completo(10, 3, 2023, 5), &posicao));
+    CONFERIR(!indice.Buscar(completo(2, 1, 2022, 5), &posicao));
+
+    long long primeira, ultima;
+    Momento marco(MOMENTO_DONT_COMPARE, 3, 2023, MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE);
+    CONFERIR(indice.GetIntervalo(marco.GetLimiteInferior(), marco.GetLimiteSuperior(), &primeira, &ultima));
+    CONFERIR(indice.GetMomento(primeira) == completo(1, 3, 2023, 0));
+    CONFERIR(indice.GetMomento(ultima) == completo(31, 3, 2023, 23));
+
+    long long presentes = 0;
+    for (long long h = primeira; h <= ultima; h++)
+        presentes += indice.IsPresente(h);
+    CONFERIR(presentes == 30 * 24);
+
+    // Intervalos além do indexado são limitados a ele, ou ficam vazios.
+    Momento ano(MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE, 2023, MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE);
+    CONFERIR(indice.GetIntervalo(completo(1, 1, 2020, 0), ano.GetLimiteSuperior(), &primeira, &ultima));
+    CONFERIR(primeira == 0 && indice.GetMomento(ultima) == completo(31, 12, 2023, 23));
+    CONFERIR(!indice.GetIntervalo(completo(1, 1, 2020, 0), completo(31, 12, 2020, 23), &primeira, &ultima));
+}
+
+static std::string ler(const std::string &caminho)
+{
+    std::ifstream arquivo(caminho, std::ios::binary);
+    std::stringstream conteudo;
+    conteudo << arquivo.rdbuf();
+    return conteudo.str();
+}
+
+static void escrever(const std::string &caminho, const std::string &conteudo, bool acrescentar)
+{
+    std::ofstream arquivo(caminho, acrescentar ? std::ios::binary | std::ios::app : std::ios::binary);
+    arquivo << conteudo;
+}
+
+static long long contar(Series &series, Momento de, Momento ate)
+{
+    long long linhas = 0;
+    series.ParaCada(de, ate, [&linhas](const Linha &) -> bool
+                    {
+                        linhas++;
+                        return true;
+                    });
+    return linhas;
+}
+
+static void testarSeries(const std::string &diretorio)
+{
+    std::string caminho = diretorio + "/testes.csv";
+    OpcoesGerador gerador = GetOpcoesGeradorPadrao(2);
+    CONFERIR(GerarArquivo(caminho.c_str(), gerador));
+
+    const int modos[] = {0, SERIES_INDICE_COMPACTO, SERIES_CARREGAR_TUDO | SERIES_PIRAMIDE, SERIES_INDICE_SAZONAL};
+    for (int opcoes : modos)
+    {
+        Series series(caminho.c_str(), opcoes);
+        Linha linha;
+
+        // Momentos parciais: a primeira linha que combina com eles.
+        CONFERIR(series.GetLinha(Momento(3, 3, 2023, MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE), &linha));
+        CONFERIR(linha.momento == completo(3, 3, 2023, 0));
+        CONFERIR(series.GetLinha(Momento(MOMENTO_DONT_COMPARE, 7, 2024, 15, MOMENTO_DONT_COMPARE), &linha));
+        CONFERIR(linha.momento == completo(1, 7, 2024, 15));
+        CONFERIR(series.GetLinha(Momento(29, 2, 2024, MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE), &linha));
+        CONFERIR(!series.GetLinha(Momento(1, 1, 2021, MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE), &linha));
+
+        // Datas impossíveis não caem em outro dia.
+        CONFERIR(!series.GetLinha(Momento(29, 2, 2023, MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE), &linha));
+        CONFERIR(!series.GetLinha(completo(31, 4, 2024, 0), &linha));
+
+        Momento dia(29, 2, 2024, MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE);
+        CONFERIR(contar(series, dia, dia) == 24);
+        Momento impossivel(30, 2, 2024, MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE);
+        CONFERIR(contar(series, impossivel, impossivel) == 0);
+        Momento julho(MOMENTO_DONT_COMPARE, 7, MOMENTO_DONT_COMPARE, 15, 0);
+        CONFERIR(contar(series, julho, julho) == 2 * 31);
+    }
+
+    // A última linha indexada sem a quebra de linha é completada por Atualizar.
+    std::string conteudo = ler(caminho);
+    std::string parcial = diretorio + "/testes_parcial.csv";
+    size_t corte = conteudo.find('\n', conteudo.size() / 2) - 2;
+    for (int opcoes : modos)
+    {
+        escrever(parcial, conteudo.substr(0, corte), false);
+        Series series(parcial.c_str(), opcoes);
+        escrever(parcial, conteudo.substr(corte), true);
+
+        long long novas = -1;
+        CONFERIR(series.Atualizar(&novas));
+
+        Series inteira(caminho.c_str(), opcoes);
+        Momento todos(MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE);
+        long long linhas = contar(inteira, todos, todos);
+        CONFERIR(contar(series, todos, todos) == linhas);
+
+        Agregado atualizados[QUANTIDADE_VARIAVEIS], esperados[QUANTIDADE_VARIAVEIS];
+        Momento ano(MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE, 2024, MOMENTO_DONT_COMPARE, MOMENTO_DONT_COMPARE);
+        CONFERIR(series.Agregar(ano, ano, VARIAVEIS_TODAS, atualizados));
+        CONFERIR(inteira.Agregar(ano, ano, VARIAVEIS_TODAS, esperados));
+        for (int i = 0; i < QUANTIDADE_VARIAVEIS; i++)
+        {
+            CONFERIR(atualizados[i].validos == esperados[i].validos);
+            CONFERIR(atualizados[i].GetMaximo() == esperados[i].GetMaximo() || atualizados[i].validos == 0);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    testarDatasImpossiveis();
+    testarInstantes();
+    testarArvore();
+    testarIndiceHorario();
+    testarSeries(argc > 1 ? argv[1] : ".");
+
+    if (falhas > 0)
+    {
+        fprintf(stderr, "%d falha(s)\n", falhas);
+        return 1;
+    }
+
+    printf("ok\n");
+    return 0;
+}